@@ -0,0 +1,47 @@
+#-------------------------------------------------------------------------------------
+# This is part of CMake configuration file for building makefiles and installfiles
+# for the AGrilla project
+#-------------------------------------------------------------------------------------
+# This script creates the source file "embedded-resources.cpp" with the content of
+# the SVG icons, so that they are compiled into the executable and there is no need
+# to locate and read the icon files at startup.
+#
+# It is run at build time, when any of the icons changes:
+#   cmake -DSOURCE_DIR=<dir> -DOUTPUT_FILE=<file> -DRESOURCES="res/a.svg|res/b.svg|..."
+#         -P embed-resources.cmake
+#-------------------------------------------------------------------------------------
+
+set(CONTENT "// Generated by embed-resources.cmake from the icons in 'res/'. Do not edit.\n\n")
+string(APPEND CONTENT "#include \"EmbeddedResources.h\"\n\n")
+string(APPEND CONTENT "namespace agrilla\n{\n\n")
+
+string(REPLACE "|" ";" RESOURCES "${RESOURCES}")
+set(TABLE "")
+set(INDEX 0)
+foreach(RESOURCE ${RESOURCES})
+  if(RESOURCE MATCHES "\\.svg$")
+    get_filename_component(NAME ${RESOURCE} NAME)
+    file(READ "${SOURCE_DIR}/${RESOURCE}" HEX_DATA HEX)
+
+    # 16 bytes per line, as "0x3c,0x73,..."
+    string(REGEX REPLACE "(................................)" "\\1\n" HEX_DATA "${HEX_DATA}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," HEX_DATA "${HEX_DATA}")
+
+    string(APPEND CONTENT "//${NAME}\n")
+    string(APPEND CONTENT "static const unsigned char k_data_${INDEX}[] = {\n${HEX_DATA}\n};\n\n")
+    string(APPEND TABLE "    { \"${NAME}\", k_data_${INDEX}, sizeof(k_data_${INDEX}) },\n")
+    math(EXPR INDEX "${INDEX} + 1")
+  endif()
+endforeach()
+
+string(APPEND CONTENT "const EmbeddedResource k_embedded_resources[] = {\n${TABLE}")
+string(APPEND CONTENT "    { nullptr, nullptr, 0 }\n};\n\n")
+string(APPEND CONTENT "}   //namespace agrilla\n")
+
+# Only rewrite the file when its content changes, to avoid useless recompilations
+if(EXISTS "${OUTPUT_FILE}")
+  file(READ "${OUTPUT_FILE}" OLD_CONTENT)
+endif()
+if(NOT "${OLD_CONTENT}" STREQUAL "${CONTENT}")
+  file(WRITE "${OUTPUT_FILE}" "${CONTENT}")
+endif()
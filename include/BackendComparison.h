@@ -0,0 +1,66 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "LayerBuilder.h"
+#include "PaintBackend.h"
+#include "RenderLayer.h"
+#include "ResourceCache.h"
+
+//std
+#include <memory>
+#include <vector>
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//BackendComparison paints the same window states through each PaintBackend, on a
+//memory bitmap, and reports, for each backend and state, the median paint time, the
+//size of the backend pixel buffers (only for backends owning them) and the number of
+//pixels that differ from the output of the reference backend (the first one in
+//PaintBackend::get_names()). It is run with option --compare-backends, and the report
+//has a line per backend and state, such as
+//  "paint_backend name=raster state=1920x1080/10 ms=1.25 kb=6075 diff_pixels=0"
+//---------------------------------------------------------------------------------------
+class BackendComparison
+{
+public:
+    explicit BackendComparison(const LayerColours& colours, int repeat = 10);
+
+    wxString run();
+
+private:
+    struct State
+    {
+        int width;
+        int height;
+        int segments;
+    };
+
+    void build_state(const State& state);
+    double paint_median_ms(PaintBackend& backend, wxBitmap& bitmap);
+    static long count_diff_pixels(const wxImage& reference, const wxImage& image);
+
+    LayerColours m_colours;
+    int m_repeat;
+    ResourceCache m_resources;
+    RenderLayer m_layers[k_layer_max];
+};
+
+
+} // namespace agrilla
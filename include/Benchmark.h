@@ -0,0 +1,102 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//std
+#include <vector>
+
+
+namespace agrilla
+{
+
+class MainFrame;
+
+//---------------------------------------------------------------------------------------
+// Options for the benchmark, from the command line
+struct BenchmarkOptions
+{
+    int repeat = 5;                 //times each stage is measured. The median is reported
+    bool fQuick = false;            //only a few sizes and grid options
+    wxString outputFile;            //JSON results. Empty for stdout
+    wxString baselineFile;          //previous results to compare with
+    wxString saveBaselineFile;      //file to save the results as new baseline
+    double threshold = 0.20;        //slowdown, relative to baseline, to report a regression
+};
+
+//---------------------------------------------------------------------------------------
+// A combination of window size and grid options to measure
+struct BenchmarkCase
+{
+    int width;
+    int height;
+    int segments;
+    int thickness;
+    bool fGrid;
+    bool fGoldenLines;
+    bool fFrame;
+
+    wxString get_key() const;
+};
+
+//---------------------------------------------------------------------------------------
+// Timings, in microseconds, for each stage of the draw and shape pipeline
+struct BenchmarkResult
+{
+    BenchmarkCase bcase;
+    double layout = 0.0;            //GridLayout: geometry of all primitives
+    double rasterize = 0.0;         //build_mask(): layers and shape rectangles
+    double regionAnalytic = 0.0;    //wxRegion from the shape rectangles
+    double applyShape = 0.0;        //setting the window shape
+    double paint = 0.0;             //repainting the window
+    double pixelFill = 0.0;         //PixelRasterizer: the layers into a window-size buffer.
+                                    //Not in the total, that stays comparable with
+                                    //older baselines
+    size_t numRects = 0;            //number of rectangles in the shape
+
+    double get_total() const { return layout + rasterize + regionAnalytic + applyShape + paint; }
+};
+
+//=======================================================================================
+//Benchmark measures how the draw and shape pipeline of MainFrame scales with the window
+//size and the grid options. It is only built in the 'agrilla_bench' target and must
+//run under an X server (e.g. Xvfb, see scripts/run-benchmark.sh).
+//Results are reported as JSON, one case per line, so that they can be saved and used
+//as baseline to detect performance regressions.
+//---------------------------------------------------------------------------------------
+class Benchmark
+{
+public:
+    Benchmark(MainFrame* pFrame, const BenchmarkOptions& options);
+
+    //returns the process exit code: 0 when no regressions
+    int run();
+
+private:
+    std::vector<BenchmarkCase> create_cases() const;
+    BenchmarkResult measure(const BenchmarkCase& bcase);
+    void prepare_frame(const BenchmarkCase& bcase);
+    wxString results_to_json(const std::vector<BenchmarkResult>& results) const;
+    wxString result_to_json(const BenchmarkResult& result) const;
+    bool write_file(const wxString& filename, const wxString& content) const;
+    int compare_with_baseline(const std::vector<BenchmarkResult>& results) const;
+
+    template <typename F> double median_time(F stage);
+
+    MainFrame* m_pFrame;
+    BenchmarkOptions m_options;
+};
+
+
+} // namespace agrilla
@@ -0,0 +1,120 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//std
+#include <chrono>
+
+
+namespace agrilla
+{
+
+// Events counted per second
+enum EDiagCounter
+{
+    k_diag_paints = 0,      //MainFrame paint events
+    k_diag_shapes,          //window shape rebuilds
+    k_diag_motion,          //mouse motion events
+    k_diag_rebuilds,        //layers rebuilt in build_mask()
+    k_diag_cache_restores,  //layers restored from the shape cache in build_mask()
+    k_diag_background,      //layers sent to the render thread by build_mask()
+    //
+    k_diag_counter_max
+};
+
+// Operations whose duration is measured
+enum EDiagDuration
+{
+    k_diag_draw = 0,        //build_mask()
+    k_diag_set_shape,       //setting the window shape
+    //
+    k_diag_duration_max
+};
+
+//=======================================================================================
+//Diagnostics collects event counters and operation durations for the HUD shown in the
+//toolbar strip (see MainFrame::toggle_hud()). Recording is a counter increment or a
+//store in a fixed size ring buffer, so it can be left enabled during real sessions.
+//Rates and percentiles are only computed in sample(), once per second.
+//---------------------------------------------------------------------------------------
+class Diagnostics
+{
+public:
+    Diagnostics() {}
+
+    void enable(bool value);
+    bool is_enabled() const { return m_fEnabled; }
+
+    //recording
+    inline void count(EDiagCounter counter) { ++m_counts[counter]; ++m_totals[counter]; }
+    void add_duration(EDiagDuration what, double ms);
+
+    //computes the rates since previous sample and returns the HUD text
+    wxString sample();
+
+    //number of events since the program start, even when not enabled
+    unsigned long long get_total(EDiagCounter counter) const { return m_totals[counter]; }
+
+private:
+    double get_p99(EDiagDuration what) const;
+
+    static const int k_samples = 256;
+
+    struct DurationSamples
+    {
+        double values[k_samples] = {};
+        int next = 0;
+        int size = 0;
+        double last = 0.0;
+    };
+
+    bool m_fEnabled = false;
+    unsigned m_counts[k_diag_counter_max] = {};
+    unsigned long long m_totals[k_diag_counter_max] = {};
+    DurationSamples m_durations[k_diag_duration_max];
+    std::chrono::steady_clock::time_point m_lastSample;
+};
+
+//---------------------------------------------------------------------------------------
+//Measures the duration of a scope and adds it to Diagnostics, if enabled
+class DiagnosticsTimer
+{
+public:
+    DiagnosticsTimer(Diagnostics& diag, EDiagDuration what)
+        : m_diag(diag)
+        , m_what(what)
+    {
+        if (m_diag.is_enabled())
+            m_start = std::chrono::steady_clock::now();
+    }
+
+    ~DiagnosticsTimer()
+    {
+        if (m_diag.is_enabled())
+        {
+            std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - m_start;
+            m_diag.add_duration(m_what, elapsed.count());
+        }
+    }
+
+private:
+    Diagnostics& m_diag;
+    EDiagDuration m_what;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+
+} // namespace agrilla
@@ -0,0 +1,51 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+#include <wx/bmpbndl.h>
+
+//std
+#include <cstddef>
+
+
+namespace agrilla
+{
+
+//A resource file compiled into the executable
+struct EmbeddedResource
+{
+    const char* name;               //file name, e.g. "grid-on.svg"
+    const unsigned char* data;
+    size_t size;
+};
+
+//The table of embedded resources, terminated by an entry with null name. It is
+//generated at build time by embed-resources.cmake from the RESOURCE_FILES icons
+extern const EmbeddedResource k_embedded_resources[];
+
+//=======================================================================================
+//EmbeddedResources gives access to the icons compiled into the executable. An
+//optional icons folder can be used for theming: when it contains a file with the same
+//name it is used instead of the embedded icon.
+//---------------------------------------------------------------------------------------
+class EmbeddedResources
+{
+public:
+    static const EmbeddedResource* find(const wxString& name);
+    static wxBitmapBundle get_svg_icon(const wxString& name, const wxSize& size,
+                                       const wxString& overrideDir = wxEmptyString);
+};
+
+
+} // namespace agrilla
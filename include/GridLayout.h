@@ -0,0 +1,140 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+//std
+#include <vector>
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+// A rectangle in window client coordinates. Same semantics as wxRect, but without
+// depending on wxWidgets
+struct LayoutRect
+{
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    LayoutRect() {}
+    LayoutRect(int left, int top, int w, int h) : x(left), y(top), width(w), height(h) {}
+
+    int get_right() const { return x + width - 1; }
+    int get_bottom() const { return y + height - 1; }
+    bool is_empty() const { return width <= 0 || height <= 0; }
+    bool contains(int px, int py) const
+    {
+        return px >= x && py >= y && px < x + width && py < y + height;
+    }
+    LayoutRect inflated(int d) const { return LayoutRect(x - d, y - d, width + 2*d, height + 2*d); }
+};
+
+//---------------------------------------------------------------------------------------
+// Everything that determines the geometry of the grid window
+struct GridLayoutOptions
+{
+    int width = 0;                  //window client size
+    int height = 0;
+    int toolbarHeight = 0;
+    bool fFrame = false;
+    int frameThickness = 0;
+    bool fGrid = true;
+    int gridSize = 3;               //number of segments in each direction
+    int lineThickness = 1;
+    bool fGoldenLines = true;
+    bool fHandlers = true;
+    int handlerSide = 15;
+
+    bool operator ==(const GridLayoutOptions& o) const;
+    bool operator !=(const GridLayoutOptions& o) const { return !(*this == o); }
+};
+
+// The areas of the window, for hit-testing
+enum EGridZone
+{
+    k_zone_outside = 0,     //toolbar, frame or outside the window
+    k_zone_grid,            //inside the grid, but not on a handle
+    k_zone_handle_right,
+    k_zone_handle_left,
+    k_zone_handle_top,
+    k_zone_handle_bottom,
+};
+
+// Index of each handle in GridLayout::get_handles()
+enum EGridHandle
+{
+    k_handle_right = 0,
+    k_handle_left,
+    k_handle_top,
+    k_handle_bottom,
+    //
+    k_handle_max
+};
+
+//=======================================================================================
+//GridLayout computes the geometry of all the primitives of the grid window (toolbar
+//strip, frame bands, grid lines, golden lines, border lines and resize handles) from
+//the window size and the grid options. It has no dependencies on wxWidgets, so that it
+//can be tested and measured on its own.
+//All primitives are computed at once, only when the options change, into flat arrays
+//that are shared by the renderer, the window shape and the mouse hit-testing.
+//---------------------------------------------------------------------------------------
+class GridLayout
+{
+public:
+    GridLayout() {}
+
+    //returns true if the layout has been recomputed, false if options didn't change
+    bool update(const GridLayoutOptions& options);
+
+    //accessors
+    const GridLayoutOptions& get_options() const { return m_options; }
+    const LayoutRect& get_client_rect() const { return m_clientRect; }
+    const LayoutRect& get_grid_rect() const { return m_gridRect; }
+    const LayoutRect& get_toolbar_rect() const { return m_toolbarRect; }
+    const std::vector<LayoutRect>& get_frame_bands() const { return m_frameBands; }
+    const std::vector<LayoutRect>& get_grid_lines() const { return m_gridLines; }
+    const std::vector<LayoutRect>& get_golden_lines() const { return m_goldenLines; }
+    const std::vector<LayoutRect>& get_border_lines() const { return m_borderLines; }
+    const std::vector<LayoutRect>& get_handles() const { return m_handles; }
+
+    //hit-testing
+    EGridZone hit_test(int x, int y) const;
+
+    //line primitives
+    LayoutRect vertical_line(int x, int top, int height) const;
+    LayoutRect horizontal_line(int left, int y, int width) const;
+
+private:
+    void compute();
+    void compute_frame_bands();
+    void compute_grid_lines();
+    void compute_golden_lines();
+    void compute_border_lines();
+    void compute_handles();
+
+    GridLayoutOptions m_options;
+    bool m_fValid = false;
+
+    LayoutRect m_clientRect;                //window area below the toolbar
+    LayoutRect m_gridRect;                  //client area minus the frame
+    LayoutRect m_toolbarRect;
+    std::vector<LayoutRect> m_frameBands;   //top, bottom, left, right
+    std::vector<LayoutRect> m_gridLines;    //vertical lines first, then horizontal
+    std::vector<LayoutRect> m_goldenLines;
+    std::vector<LayoutRect> m_borderLines;
+    std::vector<LayoutRect> m_handles;      //indexed by EGridHandle. Empty if no handles
+};
+
+
+} // namespace agrilla
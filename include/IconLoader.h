@@ -0,0 +1,71 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+#include <wx/bmpbndl.h>
+
+//std
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//IconLoader creates the toolbar icons in worker threads, so that the window can be
+//shown without waiting for the SVG parsing. Each request is answered with a
+//wxEVT_THREAD event, sent to the owner, whose id is the request id, GetInt() the
+//request variant and whose payload is the wxBitmapBundle. The bundle is rasterized,
+//at the size required by the window DPI, when it is first painted.
+//---------------------------------------------------------------------------------------
+class IconLoader
+{
+public:
+    IconLoader(wxEvtHandler* pOwner, const wxSize& size, const wxString& overrideDir);
+    ~IconLoader();
+
+    void request(int id, int variant, const wxString& name);
+
+    //discards the pending requests and waits for the workers to finish
+    void stop();
+
+private:
+    void worker_thread();
+
+    static const int k_max_workers = 4;
+
+    struct Request
+    {
+        int id;
+        int variant;
+        wxString name;
+    };
+
+    wxEvtHandler* m_pOwner;
+    wxSize m_size;
+    wxString m_overrideDir;
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Request> m_requests;
+    bool m_fStop = false;
+};
+
+
+} // namespace agrilla
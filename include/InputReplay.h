@@ -0,0 +1,115 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//std
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+namespace agrilla
+{
+
+class MainFrame;
+
+// Kinds of recorded input events. The value is the code used in the file
+enum EInputKind
+{
+    k_input_left_down = 'D',
+    k_input_motion = 'M',
+    k_input_left_up = 'U',
+    k_input_left_dclick = 'C',
+    k_input_tool = 'T',         //x is the tool id and y is 1 if checked
+};
+
+// Flags for mouse events
+enum EInputFlags
+{
+    k_input_left_is_down = 0x01,
+    k_input_control_down = 0x02,
+};
+
+// A recorded event. Mouse positions are in screen coordinates
+struct InputEvent
+{
+    long long time;     //microseconds since the recording start
+    char kind;          //EInputKind
+    int x;
+    int y;
+    int flags;          //EInputFlags
+};
+
+//=======================================================================================
+//InputRecorder saves the mouse and toolbar events received by MainFrame. Events are
+//kept in memory and written when the recording stops, as a text file with a header
+//line with the initial frame rectangle and one line per event:
+//  agrilla-input 1 <x> <y> <width> <height>
+//  <time> <kind> <x> <y> <flags>
+//---------------------------------------------------------------------------------------
+class InputRecorder
+{
+public:
+    InputRecorder() {}
+
+    void start(const wxString& filename, const wxRect& frameRect);
+    void stop();        //writes the file
+    inline bool is_recording() const { return m_fRecording; }
+
+    void add(EInputKind kind, const wxPoint& pos, int flags);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    bool m_fRecording = false;
+    wxString m_filename;
+    wxRect m_frameRect;
+    Clock::time_point m_start;
+    std::vector<InputEvent> m_events;
+};
+
+//=======================================================================================
+//InputReplay sends the events of a recording to MainFrame, with the original timing
+//or as fast as possible, and measures the time to process each event, including the
+//paint and timer events it causes. The report has a summary line, the drag latency
+//(see MainFrame::apply_pending_geometry()) and a line with the latency statistics
+//for each kind of event (the summary line is wrapped here):
+//  replay events=1520 total_ms=8400.12 paints=310 rebuilds=12 cache_restores=4
+//      background_builds=280 shapes=305
+//  latency_ms name=drag n=290 p50=6.02 p95=9.73 p99=12.03 max=14.55
+//  replay_latency kind=motion n=1480 mean_ms=1.21 p50_ms=0.95 p99_ms=6.10 max_ms=9.33
+//---------------------------------------------------------------------------------------
+class InputReplay
+{
+public:
+    InputReplay(MainFrame* pFrame, bool fMaxSpeed);
+
+    bool load(const wxString& filename);
+    wxString run();     //returns the report
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void wait_until(Clock::time_point time);
+    static const char* get_kind_name(char kind);
+
+    MainFrame* m_pFrame;
+    bool m_fMaxSpeed;
+    wxRect m_frameRect;
+    std::vector<InputEvent> m_events;
+};
+
+
+} // namespace agrilla
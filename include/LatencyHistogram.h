@@ -0,0 +1,57 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//LatencyHistogram counts latencies, in microseconds, with a relative precision of 3%
+//and constant memory, as the HDR histograms: values below 32 have their own bucket,
+//and each power of two range above it is divided in 32 buckets. Recording a value is
+//a few integer operations. Values above one hour are counted as one hour.
+//---------------------------------------------------------------------------------------
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(long long microseconds);
+    void reset();
+
+    long long get_count() const { return m_count; }
+    long long get_max() const { return m_max; }
+    long long get_percentile(double percentile) const;
+
+    //a line such as "latency_ms name=drag n=512 p50=4.10 p95=8.19 p99=12.29 max=15.02"
+    wxString get_report(const char* name) const;
+
+private:
+    static int get_bucket(long long value);
+    static long long get_bucket_limit(int bucket);
+
+    static const int k_sub_bits = 5;
+    static const int k_sub_buckets = 1 << k_sub_bits;
+    static const int k_max_bit = 32;        //2^32 us is more than one hour
+    static const int k_num_buckets = k_sub_buckets * (k_max_bit - k_sub_bits + 1);
+
+    unsigned m_counts[k_num_buckets];
+    long long m_count;
+    long long m_max;
+};
+
+
+} // namespace agrilla
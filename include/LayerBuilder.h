@@ -0,0 +1,68 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "GridLayout.h"
+#include "RenderLayer.h"
+#include "ShapeBuilder.h"
+
+//std
+#include <cstdint>
+#include <initializer_list>
+
+
+namespace agrilla
+{
+
+// The colours of the layers, as RGBA values (see wxColour::GetRGBA()). wxColour is
+// reference counted without locks, so plain values are used to pass the colours to
+// the render thread
+struct LayerColours
+{
+    uint32_t toolbar = 0;
+    uint32_t frame = 0;
+    uint32_t gridLines = 0;
+    uint32_t goldenLines = 0;
+};
+
+//=======================================================================================
+//LayerBuilder fills the render layers with the coloured rectangles of a GridLayout,
+//and collects them for the window shape. It only uses its arguments, and creates its
+//own wxColour objects, so it can also run in the render thread (see RenderThread).
+//---------------------------------------------------------------------------------------
+class LayerBuilder
+{
+public:
+    //rebuilds the layers marked as dirty
+    static void build_dirty_layers(const GridLayout& layout, const LayerColours& colours,
+                                   RenderLayer* pLayers);
+
+    //adds the rectangles of the given layers to the shape
+    static void add_to_shape(const RenderLayer* pLayers, std::initializer_list<int> layers,
+                             ShapeBuilder& shape);
+
+private:
+    static void build_toolbar_layer(const GridLayout& layout, const wxColour& colour,
+                                    RenderLayer& layer);
+    static void build_border_layer(const GridLayout& layout, RenderLayer& layer);
+    static void build_resize_handlers(const GridLayout& layout, RenderLayer& layer);
+    static void add_layout_rects(RenderLayer& layer, const std::vector<LayoutRect>& rects,
+                                 const wxColour& colour);
+    static wxColour make_colour(uint32_t rgba);
+};
+
+
+} // namespace agrilla
@@ -13,12 +13,32 @@
 #ifndef WX_PRECOMP
     #include "wx/wx.h"
 #endif
+#include <wx/timer.h>
+
+//std
+#include <vector>
+#include <chrono>
+#include <initializer_list>
+#include <memory>
+
+//agrilla
+#include "ShapeBuilder.h"
+#include "ShapeCache.h"
+#include "RenderLayer.h"
+#include "RenderThread.h"
+#include "GridLayout.h"
+#include "ResourceCache.h"
+#include "Diagnostics.h"
+#include "InputReplay.h"
+#include "PaintBackend.h"
+#include "LatencyHistogram.h"
 
 
 namespace agrilla
 {
 
 class ToolBar;
+class Benchmark;
 
 // Enum to define which part of the border is being resized
 enum class ResizeDirection
@@ -34,13 +54,51 @@ class MainFrame : public wxFrame
 {
 public:
     MainFrame(const wxSize& initialSize = wxSize(400, 300));
+    ~MainFrame();
 
     //public event handlres so that ToolBar can bind events to this MainFrame
     void on_mouse_left_down(wxMouseEvent& event);
     void on_mouse_motion(wxMouseEvent& event);
     void on_mouse_left_up(wxMouseEvent& event);
+    void on_mouse_left_dclick(wxMouseEvent& event);
+
+    //input replay, see InputReplay
+    void replay_input(const InputEvent& input);
+    const Diagnostics& get_diagnostics() const { return m_diagnostics; }
+    const LatencyHistogram& get_drag_latency() const { return m_dragLatency; }
+
+    //the current colours, for BackendComparison
+    LayerColours get_layer_colours() const;
 
 private:
+    friend class Benchmark;     //access to the draw and shape pipeline stages
+
+    // A geometry transaction collects the changes in window position and size, and in
+    // the options that affect the layers, and applies all of them with a single
+    // SetSize() and a single shape rebuild, when committed or destroyed. Compound
+    // changes do not produce intermediate configures, paints and shapes.
+    class GeometryTransaction
+    {
+    public:
+        explicit GeometryTransaction(MainFrame* pFrame);
+        ~GeometryTransaction();
+
+        void set_client_size(const wxSize& size);
+        wxSize get_client_size() const;
+        void show_frame(bool fShow);
+        void show_grid(bool fShow);
+        void show_golden_lines(bool fShow);
+        void invalidate_layer(int layer);
+        void commit();
+
+    private:
+        MainFrame* m_pFrame;
+        wxRect m_rect;              //the new frame rect, in screen coordinates
+        wxSize m_decorations;       //frame size minus client size
+        std::vector<int> m_layers;  //the layers to rebuild
+        bool m_fAllLayers = false;
+        bool m_fCommitted = false;
+    };
 
     // Event handlers
     void on_paint(wxPaintEvent& event);
@@ -52,17 +110,45 @@ private:
     void on_tool_show_golden_lines(wxCommandEvent& event);
     void on_tool_show_frame(wxCommandEvent& event);
     void on_about(wxCommandEvent& WXUNUSED(event));
+    void on_drag_timer(wxTimerEvent& event);
+    void on_hud_timer(wxTimerEvent& event);
+    void on_idle(wxIdleEvent& event);
+
+    //helpers for input recording
+    void record_mouse(EInputKind kind, const wxMouseEvent& event);
+    void record_tool(const wxCommandEvent& event);
 
     //helpers for building
     void create_toolbar();
     void create_shaped_frame();
+    void apply_shape();
+    void apply_approximate_shape();
+    void add_layers_to_shape(ShapeBuilder& shape, std::initializer_list<int> layers) const;
+
+    //helpers for the ARGB overlay mode
+    void select_overlay_mode();
+    void select_paint_backend();
+    void paint_argb_overlay();
 
     //helpers for drawing
-    void draw_all_content();
-    void draw_grid_lines(wxDC& dc);
-    void draw_golden_lines(wxDC& dc);
-    void draw_border(wxDC& dc);
-    void draw_resize_handlers(wxDC& dc);
+    void build_mask(bool fInBackground = false);
+    ShapeKey get_shape_key(const GridLayoutOptions& options) const;
+
+    //helpers for building in the render thread
+    bool use_render_thread() const;
+    void submit_render(const GridLayoutOptions& options);
+    void on_render_done(wxThreadEvent& event);
+
+    //helpers for the render layers
+    void update_layers(const wxSize& size);
+    void update_layout(const wxSize& size);
+    void check_layers_size(const wxSize& size);
+    GridLayoutOptions get_layout_options(const wxSize& size) const;
+    bool has_dirty_layers() const;
+    void invalidate_layer(int layer);
+    void invalidate_all_layers();
+    void refresh_layers(const std::vector<int>& layers);
+    void refresh_layer_area(int layer);
 
     //helpers, to manage options
     void get_grid_options();
@@ -74,6 +160,21 @@ private:
     void resize_window_mouse_motion(wxMouseEvent& event);
     void resize_window_left_mouse_up(wxMouseEvent& event);
     ResizeDirection determine_resize_direction(const wxPoint& mousePos);
+    void set_cursor(wxStockCursor kind);
+
+    //helpers, for pacing the window moving and resizing
+    void start_drag();
+    void queue_geometry(const wxRect& frameRect);
+    void apply_pending_geometry();
+    void finish_drag();
+
+    //helpers for building in advance the states one toolbar toggle away
+    enum ESpeculativeState { k_spec_grid = 0, k_spec_golden_lines, k_spec_frame, k_spec_max };
+    void prebuild_state(int state);
+
+    //helpers for the diagnostics HUD
+    void toggle_hud();
+    void update_hud();
 
     //other helpers
     void compute_aspect_ratio();
@@ -81,14 +182,35 @@ private:
 
 private:
     //GUI layout
-    bool        m_fBitmapIsInvalid = true;
-    wxBitmap    m_bmpMask;               //the image that will define the opaque regions
+    bool        m_fMaskIsInvalid = true;
+    bool        m_fShapeIsInvalid = false;   //m_shape has not yet been applied
+    ShapeBuilder m_shape;                //the opaque rectangles, for building the shape
+    ShapeBuilder m_partialShape;         //reused for the approximate and input shapes
+    RenderLayer m_layers[k_layer_max];   //cached content, composed into m_shape
+    ShapeCache  m_shapeCache;            //layers and shapes of previous states
+    bool        m_fCacheShape = false;   //add the state to m_shapeCache once shaped
+    int         m_nextSpeculation = 0;   //next ESpeculativeState to build when idle
+    GridLayout  m_specLayout;            //for the states built in advance
+    RenderLayer m_specLayers[k_layer_max];
+    ShapeBuilder m_specShape;
+
+    // render thread. Only in shaped mode
+    std::unique_ptr<RenderThread> m_pRenderThread;
+    bool m_fRenderPending = false;          // waiting for the result for m_renderOptions
+    GridLayoutOptions m_renderOptions;
+    unsigned m_renderGeneration = 0;        // generation of the latest submitted job
+    wxSize      m_layersSize;            //window size used for building the layers
+    int         m_layersToolbarHeight = 0;  //toolbar height used for building the layers
+    bool        m_fArgbMode = false;     //translucent window instead of shaped window
+    bool        m_fPainted = false;      //the first paint has been done
     ToolBar*    m_toolbar = nullptr;
     wxColour    m_toolbarColour;
     int m_toolbarHeight = 53;
     wxSize m_toolbarSize;
-    wxRect m_clientRect;
-    wxRect m_gridRect;
+    GridLayout m_layout;                 //geometry of all the drawn primitives
+    ResourceCache m_resources;           //pens, brushes and cursors
+    std::unique_ptr<PaintBackend> m_pPaintBackend;  //paints the layers
+    wxStockCursor m_cursorKind = wxCURSOR_ARROW;  //the cursor currently set
 
     // for moving the window
     bool m_fMoveMode = false;
@@ -99,16 +221,13 @@ private:
     //handlers for resizing
     int m_handlerSide = 15;
     bool m_fDrawHandlers = true;
-    wxRect m_leftHandle;
-    wxRect m_rightHandle;
-    wxRect m_topHandle;
-    wxRect m_bottomHandle;
 
     // Grid properties
     bool m_fDrawGrid = true;
     int m_gridSize;
     int m_gridLineThickness;
     wxColour m_gridLinesColour;
+    unsigned char m_linesOpacity = 255;  //only used in ARGB overlay mode
 
     // Golden lines
     bool m_fDrawGoldenLines = true;
@@ -129,6 +248,26 @@ private:
     ResizeDirection m_resizeDirection = ResizeDirection::NONE; // Which border is currently being dragged
     wxSize m_resizeStartFrameSize;           // Frame size when resize starts
 
+    // drag pacing: geometry changes are applied at most once per display frame
+    wxTimer m_dragTimer;
+    bool m_fGeometryPending = false;
+    wxRect m_pendingGeometry;                // Latest requested frame rect (screen coordinates)
+    std::chrono::steady_clock::time_point m_lastGeometryTime;  // When geometry was last changed
+    bool m_fApproximateDragShape = true;     // Use a cheap shape while resizing
+    bool m_fShapeIsApproximate = false;
+    bool m_fDragSettled = false;             // No geometry changes for a while
+
+    // drag latency: from the motion event to the end of the paint with the new shape
+    LatencyHistogram m_dragLatency;
+    bool m_fMotionPending = false;           // m_motionTime is for a queued geometry
+    std::chrono::steady_clock::time_point m_motionTime;
+    bool m_fPresentPending = false;          // m_presentTime is for an applied geometry
+    std::chrono::steady_clock::time_point m_presentTime;
+
+    // diagnostics HUD
+    Diagnostics m_diagnostics;
+    wxTimer m_hudTimer;
+
 };
 
 } // namespace agrilla
@@ -0,0 +1,107 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+#include <wx/rawbmp.h>
+
+//agrilla
+#include "PixelRasterizer.h"
+#include "RenderLayer.h"
+#include "ResourceCache.h"
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//PaintBackend paints the rectangles of the render layers on a wxDC. Several backends
+//are available, selected with preference '/Render/PaintBackend' or with option
+//--paint-backend, as the fastest one depends on the machine. BackendComparison
+//measures them (option --compare-backends).
+// - "gc": wxGraphicsContext (Cairo on GTK). Consecutive rectangles of the same colour
+//   are filled at once, as a single path. The default, and the only one supporting
+//   the lines opacity required by the ARGB overlay mode.
+// - "dc": a wxDC::DrawRectangle() call for each rectangle.
+// - "raster": the rectangles are written into the pixels of a bitmap, and the pixels
+//   written are blitted once for each rectangle of the damaged region.
+//Only the rectangles touching the damaged region are painted.
+//---------------------------------------------------------------------------------------
+class PaintBackend
+{
+public:
+    virtual ~PaintBackend() {}
+
+    //returns nullptr if the name is not valid
+    static PaintBackend* create(const wxString& name, ResourceCache& resources);
+    static wxArrayString get_names();
+
+    virtual const char* get_name() const = 0;
+    virtual void paint(wxDC& dc, const RenderLayer* pLayers, const wxRegion& damaged,
+                       unsigned char linesAlpha) = 0;
+
+    //backends owning pixel buffers report their size
+    virtual bool has_buffers() const { return false; }
+    virtual size_t get_memory_bytes() const { return 0; }
+};
+
+//---------------------------------------------------------------------------------------
+class GcPaintBackend : public PaintBackend
+{
+public:
+    explicit GcPaintBackend(ResourceCache& resources) : m_resources(resources) {}
+
+    const char* get_name() const override { return "gc"; }
+    void paint(wxDC& dc, const RenderLayer* pLayers, const wxRegion& damaged,
+               unsigned char linesAlpha) override;
+
+private:
+    ResourceCache& m_resources;
+};
+
+//---------------------------------------------------------------------------------------
+class DcPaintBackend : public PaintBackend
+{
+public:
+    explicit DcPaintBackend(ResourceCache& resources) : m_resources(resources) {}
+
+    const char* get_name() const override { return "dc"; }
+    void paint(wxDC& dc, const RenderLayer* pLayers, const wxRegion& damaged,
+               unsigned char linesAlpha) override;
+
+private:
+    ResourceCache& m_resources;
+};
+
+//---------------------------------------------------------------------------------------
+class RasterPaintBackend : public PaintBackend
+{
+public:
+    RasterPaintBackend() {}
+
+    const char* get_name() const override { return "raster"; }
+    void paint(wxDC& dc, const RenderLayer* pLayers, const wxRegion& damaged,
+               unsigned char linesAlpha) override;
+    bool has_buffers() const override { return true; }
+    size_t get_memory_bytes() const override;
+
+private:
+    void reserve_bitmap(int width, int height);
+    //the pixels of 'data', placed at the window area 'area'
+    static PixelBuffer get_pixel_buffer(wxNativePixelData& data, const wxRect& area);
+
+    wxBitmap m_bitmap;  //the pixels of the window, from (0, 0). It only grows
+};
+
+
+} // namespace agrilla
@@ -0,0 +1,98 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "RenderLayer.h"
+
+//std
+#include <vector>
+
+
+namespace agrilla
+{
+
+// A buffer of packed pixels, such as the one given by wxNativePixelData: 3 or 4 bytes
+// per pixel, with the colour channels at the given offsets. It covers the window area
+// (left, top, width, height)
+struct PixelBuffer
+{
+    unsigned char* pData = nullptr;     //the first pixel
+    int stride = 0;                     //bytes from a row to the next one
+    int left = 0;
+    int top = 0;
+    int width = 0;
+    int height = 0;
+    int pixelSize = 3;
+    int red = 0;                        //offset of each channel in the pixel
+    int green = 1;
+    int blue = 2;
+};
+
+// The bytes of a run of pixels of the same colour. Its period, k_size, is a multiple of
+// the pixel size (3 or 4 bytes) and of the vector size (16 or 32 bytes), so that a row
+// is filled by storing the pattern again and again. It goes on for one more vector,
+// so that it can be started at any offset below the vector size
+struct PixelPattern
+{
+    static const int k_size = 96;
+
+    unsigned char bytes[k_size + 32 + 4];
+    int pixelSize = 3;
+};
+
+//=======================================================================================
+//PixelRasterizer writes the opaque, axis-aligned rectangles of the layers straight into
+//a pixel buffer, without any per-primitive toolkit call:
+// - wide rectangles (horizontal lines, toolbar, frame) are filled row by row with
+//   aligned vector stores of a PixelPattern: AVX2 when the CPU has it, SSE2 on any
+//   x86-64, or fixed-size copies that the compiler vectorizes on other CPUs. Big fills
+//   use streaming stores.
+// - narrow rectangles (vertical lines) are filled as columns, all the lines with the
+//   same rows together, row by row.
+//fill_layers() also returns the coverage spans, the rectangles actually written, in
+//the same pass. The pixels not covered are not written.
+//---------------------------------------------------------------------------------------
+class PixelRasterizer
+{
+public:
+    static void make_pattern(const PixelBuffer& buffer, unsigned char red,
+                             unsigned char green, unsigned char blue,
+                             PixelPattern& pattern);
+
+    //fills the rectangles of all layers, in drawing order, clipped to 'area' and to the
+    //buffer. When pCoverage is not null, the clipped rectangles are added to it
+    static void fill_layers(const PixelBuffer& buffer, const RenderLayer* pLayers,
+                            const wxRect& area, std::vector<wxRect>* pCoverage);
+
+    //"avx2", "sse2" or "scalar": the row fill used in this CPU
+    static const char* get_row_fill_name();
+
+    //kernels. Rectangles are in window coordinates, and must be inside the buffer
+    static void fill_rect(const PixelBuffer& buffer, const wxRect& rect,
+                          const PixelPattern& pattern);
+    static void fill_rows(unsigned char* pRow, int stride, int numRows, int numPixels,
+                          const PixelPattern& pattern);
+    static void fill_columns(const PixelBuffer& buffer, const std::vector<wxRect>& rects,
+                             const PixelPattern& pattern);
+
+    //rectangles up to this width are filled as columns
+    static const int k_column_max_pixels = 4;
+    //row fills of this size or bigger use streaming stores
+    static const size_t k_stream_bytes = 2 * 1024 * 1024;
+};
+
+
+} // namespace agrilla
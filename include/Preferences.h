@@ -0,0 +1,71 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//std
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+class wxFileConfig;
+
+namespace agrilla
+{
+
+//=======================================================================================
+//Preferences owns the configuration of the application and persists it without
+//blocking the GUI. Values are read and written in memory, through the wxFileConfig
+//returned by get_config(). Invoking save() takes a snapshot of the configuration and
+//passes it to a background thread, that writes it to a temporary file and renames it
+//over the preferences file, so that the file is never left half written.
+//Several save() requests in a short time are batched in a single write. Only flush(),
+//when the application exits, waits for the file to be written.
+//---------------------------------------------------------------------------------------
+class Preferences
+{
+public:
+    Preferences(const wxString& filename);
+    ~Preferences();
+
+    //the configuration is also set as the global wxConfigBase
+    wxConfigBase* get_config();
+
+    void save();
+    void flush();
+
+private:
+    bool take_snapshot();
+    void writer_thread();
+    bool write_file(const std::string& content);
+
+    static const int k_batch_delay_ms = 250;    //time to collect more changes
+
+    wxFileConfig* m_pConfig = nullptr;      //owned by wxWidgets, as global wxConfigBase
+    wxString m_filename;                    //only read after the thread is started
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::string m_snapshot;                 //content to write. Protected by m_mutex
+    bool m_fPending = false;                //m_snapshot not yet written
+    bool m_fWriting = false;                //the thread is writing a snapshot
+    bool m_fFlush = false;                  //flush() is waiting: do not batch
+    bool m_fStop = false;
+};
+
+
+} // namespace agrilla
@@ -0,0 +1,51 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//std
+#include <vector>
+
+
+namespace agrilla
+{
+
+// Layers of the rendered content, in drawing order
+enum ERenderLayer
+{
+    k_layer_toolbar = 0,    //the coloured strip behind the toolbar
+    k_layer_frame,          //the frame around the grid
+    k_layer_grid,           //the grid lines
+    k_layer_golden_lines,   //the golden ratio lines
+    k_layer_border,         //the grid border and the resize handlers
+    //
+    k_layer_max
+};
+
+// A rectangle to fill with a colour. Colour must not be black as it is transparent
+struct FilledRect
+{
+    wxRect rect;
+    wxColour colour;
+};
+
+// The cached content of a layer. It is only rebuilt when marked as dirty
+struct RenderLayer
+{
+    bool fDirty = true;
+    std::vector<FilledRect> rects;
+};
+
+
+} // namespace agrilla
@@ -0,0 +1,89 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "GridLayout.h"
+#include "LayerBuilder.h"
+#include "RenderLayer.h"
+#include "ShapeBuilder.h"
+
+//std
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+
+namespace agrilla
+{
+
+// A snapshot of the window state to build. Only plain values, not shared with the UI
+struct RenderJob
+{
+    unsigned generation = 0;        //to recognize the result of the latest job
+    GridLayoutOptions options;
+    LayerColours colours;
+};
+
+// The layout, layers and shape rectangles built for a RenderJob
+struct RenderResult
+{
+    RenderJob job;
+    GridLayout layout;
+    RenderLayer layers[k_layer_max];
+    ShapeBuilder shape;
+};
+
+//=======================================================================================
+//RenderThread builds the layers and the shape rectangles of a window state in a worker
+//thread, so that mouse events are still handled while an expensive state (a big
+//window with many grid segments) is built.
+//Only the latest submitted job is kept: a job not yet started is replaced by a newer
+//one, and the result of a job is dropped if a newer one was submitted meanwhile.
+//Results are double-buffered: the worker builds into its own result and then
+//publishes it as the ready result, replacing any not yet taken. The owner is notified
+//with a wxEVT_THREAD event, with the given id, and takes the ready result.
+//The window shape is not set here: wxRegion and the window belong to the UI thread.
+//---------------------------------------------------------------------------------------
+class RenderThread
+{
+public:
+    RenderThread(wxEvtHandler* pOwner, int id);
+    ~RenderThread();
+
+    void submit(const RenderJob& job);
+    std::unique_ptr<RenderResult> take_result();
+
+    //discards the pending job and waits for the worker to finish
+    void stop();
+
+private:
+    void worker_thread();
+
+    wxEvtHandler* m_pOwner;
+    int m_id;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    RenderJob m_job;                            //the latest submitted job
+    bool m_fJobPending = false;                 //m_job not yet started
+    std::unique_ptr<RenderResult> m_pReady;     //newest result, not yet taken
+    bool m_fStop = false;
+};
+
+
+} // namespace agrilla
@@ -0,0 +1,53 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//std
+#include <cstdint>
+#include <unordered_map>
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//ResourceCache keeps the pens, brushes and cursors used by MainFrame, so that they
+//are created only once instead of on each rebuild or mouse event. Pens are keyed by
+//colour, width and style; brushes by colour and style; cursors by kind.
+//Returned references remain valid until clear() is invoked.
+//---------------------------------------------------------------------------------------
+class ResourceCache
+{
+public:
+    ResourceCache() {}
+
+    const wxPen& get_pen(const wxColour& colour, int width = 1,
+                         wxPenStyle style = wxPENSTYLE_SOLID);
+    const wxBrush& get_brush(const wxColour& colour,
+                             wxBrushStyle style = wxBRUSHSTYLE_SOLID);
+    const wxCursor& get_cursor(wxStockCursor kind);
+
+    void clear();
+
+private:
+    static uint64_t make_key(const wxColour& colour, int width, int style);
+
+    std::unordered_map<uint64_t, wxPen> m_pens;
+    std::unordered_map<uint64_t, wxBrush> m_brushes;
+    std::unordered_map<int, wxCursor> m_cursors;
+};
+
+
+} // namespace agrilla
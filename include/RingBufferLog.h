@@ -0,0 +1,87 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+#include <wx/log.h>
+
+//std
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//RingBufferLog is a wxLog target that does not block the GUI thread. Each message is
+//copied, with its time, level and component, into a fixed size record of an in-memory
+//ring buffer, and a background thread formats the records and writes them to the log
+//file. When the buffer is full, messages are dropped and the number of dropped
+//messages is written to the log.
+//wxWidgets only calls DoLogRecord() from the main thread (messages from other threads
+//are queued by wxLog), so the buffer has a single producer and a single consumer and
+//does not need locks.
+//
+//Log levels can be set for each module (the wxLOG_COMPONENT defined in each source
+//file) with set_levels(), e.g. "frame=debug,prefs=warning" or "*=error".
+//---------------------------------------------------------------------------------------
+class RingBufferLog : public wxLog
+{
+public:
+    RingBufferLog(FILE* pFile);
+    ~RingBufferLog();
+
+    //stops the writer thread after writing all pending messages
+    void stop();
+
+    static void set_levels(const wxString& spec);
+
+protected:
+    void DoLogRecord(wxLogLevel level, const wxString& msg,
+                     const wxLogRecordInfo& info) override;
+
+private:
+    void writer_thread();
+    void write_pending();
+    static bool parse_level(const wxString& name, wxLogLevel* pLevel);
+
+    static const int k_num_records = 1024;      //must be a power of 2
+    static const int k_text_size = 240;
+    static const int k_component_size = 16;
+
+    struct Record
+    {
+        long long timestampMS;
+        wxLogLevel level;
+        char component[k_component_size];
+        char text[k_text_size];
+    };
+
+    FILE* m_pFile;
+    Record m_records[k_num_records];
+    std::atomic<unsigned> m_head;           //next record to write. Only the producer changes it
+    std::atomic<unsigned> m_tail;           //next record to read. Only the consumer changes it
+    std::atomic<unsigned> m_dropped;
+
+    std::thread m_thread;
+    std::mutex m_mutex;                     //only for the consumer to wait
+    std::condition_variable m_cv;
+    std::atomic<bool> m_fStop;
+};
+
+
+} // namespace agrilla
@@ -0,0 +1,69 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+#include <wx/nonownedwnd.h>
+
+#include <vector>
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//ShapeBuilder collects the opaque rectangles of the shaped frame (toolbar strip, frame,
+//grid lines, golden lines, border and handles), and builds the window shape directly
+//from them. These rectangles are the mask of the window: a few KB, instead of a
+//window size bitmap that would have to be scanned to recover them.
+//clear() keeps the memory, so a builder can be reused without allocations.
+//The region is built only when first needed and kept until the rectangles change,
+//so a copied builder (see ShapeCache) does not build it again.
+//On X11 the rectangles are passed to the X server with XShapeCombineRectangles(). On
+//other platforms, when the X11 window is not available or when the X server has no
+//Shape extension, a wxRegion is built as the union of the rectangles.
+//For translucent (ARGB) windows, the rectangles can instead define only the input
+//shape: the area that receives mouse events. This requires the X11 Shape extension.
+//---------------------------------------------------------------------------------------
+class ShapeBuilder
+{
+public:
+    ShapeBuilder() {}
+
+    //building
+    void clear(const wxSize& bounds);
+    void add_rect(const wxRect& rect);
+
+    //accessors
+    const std::vector<wxRect>& get_rects() const { return m_rects; }
+    bool is_empty() const { return m_rects.empty(); }
+
+    //applying the shape
+    wxRegion build_region() const;
+    const wxRegion& get_region() const;
+    bool apply_to(wxNonOwnedWindow* pWindow) const;
+    bool apply_input_to(wxNonOwnedWindow* pWindow) const;
+    static bool has_input_shape_support();
+
+private:
+    bool apply_with_xshape(wxNonOwnedWindow* pWindow, int kind) const;
+    static bool has_shape_extension();
+
+    wxRect m_bounds;                //the window client area. Rectangles are clipped to it
+    std::vector<wxRect> m_rects;    //the opaque rectangles
+    mutable wxRegion m_region;      //built from m_rects when needed
+    mutable bool m_fRegionValid = false;
+};
+
+
+} // namespace agrilla
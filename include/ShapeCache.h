@@ -0,0 +1,95 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "RenderLayer.h"
+#include "ShapeBuilder.h"
+
+//std
+#include <cstdint>
+#include <list>
+
+
+namespace agrilla
+{
+
+// All the values that determine the content of the layers and the window shape
+struct ShapeKey
+{
+    int width = 0;
+    int height = 0;
+    int toolbarHeight = 0;
+    int gridSize = 0;
+    int lineThickness = 0;
+    int frameThickness = 0;
+    int handlerSide = 0;
+    uint32_t colours[4] = {};   //toolbar, frame, grid lines and golden lines, as RGBA
+    unsigned flags = 0;         //draw frame, grid, golden lines and handlers
+
+    bool operator==(const ShapeKey& other) const;
+};
+
+//=======================================================================================
+//ShapeCache keeps the layers and the shape built for the last window states (size,
+//grid options, colours and draw flags), so that returning to a previous state, such
+//as toggling the grid off and on again, does not rebuild them.
+//It is a LRU list bounded by a memory budget: adding an entry removes the least
+//recently used ones until the cache fits in the budget. A budget of 0 disables it.
+//There are only a few entries, so they are found by a linear search.
+//---------------------------------------------------------------------------------------
+class ShapeCache
+{
+public:
+    ShapeCache() {}
+
+    void set_budget(size_t bytes);
+    bool is_enabled() const { return m_budget > 0; }
+    void clear();
+    bool contains(const ShapeKey& key) const;
+
+    //on a hit, copies the cached layers and shape and returns true
+    bool restore(const ShapeKey& key, RenderLayer* pLayers, ShapeBuilder* pShape);
+    void add(const ShapeKey& key, const RenderLayer* pLayers, const ShapeBuilder& shape);
+
+    //statistics
+    unsigned long get_hits() const { return m_hits; }
+    unsigned long get_misses() const { return m_misses; }
+    size_t get_bytes() const { return m_bytes; }
+
+    //a line such as "shape_cache hits=12 misses=4 entries=4 kb=96"
+    wxString get_report() const;
+
+private:
+    struct Entry
+    {
+        ShapeKey key;
+        std::vector<FilledRect> layers[k_layer_max];
+        ShapeBuilder shape;
+        size_t bytes = 0;
+    };
+
+    static size_t compute_bytes(const Entry& entry);
+    void trim(size_t budget);
+
+    std::list<Entry> m_entries;     //the most recently used first
+    size_t m_budget = 0;
+    size_t m_bytes = 0;
+    unsigned long m_hits = 0;
+    unsigned long m_misses = 0;
+};
+
+
+} // namespace agrilla
@@ -0,0 +1,55 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//std
+#include <chrono>
+#include <utility>
+#include <vector>
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//StartupProfile measures the duration of each startup phase, from the program start
+//(the initialization of static variables) to the end of the first paint. Each call
+//to mark() ends the current phase. The result is a single line, such as
+//  startup_ms total=41.20 wx_init=12.41 cmd_line=0.05 log=0.31 ... first_paint=4.02
+//---------------------------------------------------------------------------------------
+class StartupProfile
+{
+public:
+    StartupProfile();
+
+    //ends the current phase and starts next one. Ignored after finish()
+    void mark(const char* phase);
+    //ends the last phase and the measurements
+    void finish(const char* phase);
+
+    bool is_finished() const { return m_fFinished; }
+    wxString get_report() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point m_start;
+    Clock::time_point m_last;
+    std::vector< std::pair<const char*, double> > m_phases;     //name, milliseconds
+    bool m_fFinished = false;
+};
+
+
+} // namespace agrilla
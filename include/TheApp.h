@@ -16,10 +16,21 @@
 #endif
 #include <wx/config.h>
 
+//agrilla
+#include "InputReplay.h"
+#include "StartupProfile.h"
+
+#if defined(AGRILLA_BENCHMARK)
+    #include "Benchmark.h"
+#endif
+
 
 namespace agrilla
 {
 
+class MainFrame;
+class Preferences;
+class RingBufferLog;
 
 // Define a new application type, each program should derive a class from wxApp
 class TheApp : public wxApp
@@ -27,9 +38,25 @@ class TheApp : public wxApp
 public:
     virtual bool OnInit() override;
     virtual int OnExit() override;
+    virtual void OnInitCmdLine(wxCmdLineParser& parser) override;
+    virtual bool OnCmdLineParsed(wxCmdLineParser& parser) override;
+#if defined(AGRILLA_BENCHMARK)
+    virtual int OnRun() override;
+#endif
 
     wxConfigBase* get_preferences() { return m_pPrefs; }
-    wxString get_resources_path();
+    void save_preferences();
+    wxString get_icons_dir();
+
+    //startup timing
+    StartupProfile& get_startup_profile() { return m_startup; }
+    void on_first_paint();
+
+    //input recording and replay
+    InputRecorder& get_input_recorder() { return m_inputRecorder; }
+
+    //rendering
+    wxString get_paint_backend();
 
     //program info
     static wxString get_version_string();
@@ -40,16 +67,34 @@ public:
     static wxString get_build_date();
 
 protected:
+    void replay_input(MainFrame* pFrame);
+    void compare_backends(MainFrame* pFrame);
     void create_preferences_file();
     void create_log_file();
-    wxString get_resources_path_from_executable();
+    void configure_log_levels();
     wxString ensure_log_folder_exists(const wxString& logFileName);
     wxString ensure_config_folder_exists(const wxString& configFileName);
 
     FILE* m_logFilePtr = nullptr;
     wxLogWindow* m_pLogWindow = nullptr;
+    RingBufferLog* m_pRingLog = nullptr;    //owned by wxLog, as active target
 
     wxConfigBase* m_pPrefs = nullptr;
+    Preferences* m_pPreferences = nullptr;  //persists m_pPrefs. Null in benchmark
+
+    StartupProfile m_startup;
+    bool m_fStartupReport = false;          //print the startup times and exit
+    wxString m_traceFile;                   //file for the Tracer, or empty if disabled
+    InputRecorder m_inputRecorder;
+    wxString m_recordFile;                  //file to record the input, or empty
+    wxString m_replayFile;                  //file with the input to replay, or empty
+    bool m_fReplayMaxSpeed = false;
+    wxString m_paintBackend;                //from the command line, or empty
+    bool m_fCompareBackends = false;        //print the backends comparison and exit
+
+#if defined(AGRILLA_BENCHMARK)
+    BenchmarkOptions m_benchOptions;
+#endif
 
 };
 
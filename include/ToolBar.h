@@ -10,11 +10,14 @@
 #pragma once
 
 #include <wx/panel.h>
-#include <wx/bitmap.h>
-#include <wx/bmpbuttn.h>
-#include <wx/vector.h>
+#include <wx/bmpbndl.h>
 #include <wx/event.h>
-#include <map>
+
+//agrilla
+#include "IconLoader.h"
+
+//std
+#include <vector>
 
 namespace agrilla
 {
@@ -31,19 +34,28 @@ class MainFrame;
 //the system's theme settings,
 //So it has been decided to switch to a generic, custom-drawn toobar to have full
 //control over the toolbar and also to maintain the same appearance across platforms.
+//
+//The toolbar is a single owner-drawn window. Tools are not native buttons but records
+//in a vector, and the toolbar does its own painting, hit-testing, tooltips and check
+//state. Clicking a tool sends a wxEVT_BUTTON event, with the tool id, to MainFrame.
+//
+//Tool icons are given by name, and are created in background by an IconLoader.
+//Until an icon is available, its tool is painted as an empty slot. The checked
+//icon of a check tool is only requested when the tool is first checked.
 //---------------------------------------------------------------------------------------
 class ToolBar : public wxPanel
 {
 public:
     ToolBar(MainFrame* parent, wxWindowID id, int width, const wxSize& iconsSize,
-            const wxColour bgColour);
+            const wxColour bgColour, const wxString& iconsDir = wxEmptyString);
 
-    //building
-    void add_tool(wxWindowID id, const wxBitmapBundle& bitmap, const wxString& tooltip);
-    void add_check_tool(wxWindowID id, const wxBitmapBundle& normalBitmap,
-                        const wxBitmapBundle& checkedBitmap,
+    //building. Icons are the names of the SVG icons, e.g. "grid-on.svg"
+    void add_tool(wxWindowID id, const wxString& icon, const wxString& tooltip);
+    void add_check_tool(wxWindowID id, const wxString& normalIcon,
+                        const wxString& checkedIcon,
                         const wxString& normalTooltip, const wxString& checkedTooltip);
     void change_colour(const wxColour bgColour);
+    void set_hud_text(const wxString& text);
 
     //accessors for information
     void set_tool_checked(wxWindowID id, bool checked);
@@ -52,19 +64,49 @@ public:
     wxRect get_move_handle() const;
 
 private:
-    void on_button_click(wxCommandEvent& event);
+    // A tool: its icons, tooltips and position in the toolbar
+    struct ToolRecord
+    {
+        wxWindowID id;
+        wxString normalIcon;
+        wxString checkedIcon;
+        wxBitmapBundle normalBitmap;        //not IsOk() until loaded
+        wxBitmapBundle checkedBitmap;       //not IsOk() until loaded
+        bool fCheckedRequested;             //checkedIcon has been requested
+        wxString normalTooltip;
+        wxString checkedTooltip;
+        bool fCheckTool;
+        bool fChecked;
+        wxRect rect;
+    };
+
+    void add_tool_record(const ToolRecord& tool);
+    int find_tool(wxWindowID id) const;
+    int hit_test(const wxPoint& pos) const;
+    void set_hover_tool(int index);
+    void refresh_tool(int index);
+    void click_tool(int index);
+    void request_icon(int index, bool fChecked);
+
+    //event handlers
+    void on_paint(wxPaintEvent& event);
+    void on_mouse_left_down(wxMouseEvent& event);
+    void on_mouse_left_up(wxMouseEvent& event);
+    void on_mouse_motion(wxMouseEvent& event);
+    void on_mouse_leave(wxMouseEvent& event);
+    void on_icon_loaded(wxThreadEvent& event);
+    wxRect get_hud_rect() const;
 
+    MainFrame* m_pFrame;
     wxSize m_iconSize;
     wxColour m_bgColour;
-    wxVector<wxBitmapButton*> m_buttons;
-    std::map<wxWindowID, wxBitmapButton*> m_buttonMap; // Map ID to button pointer for quick lookup
-    std::map<wxWindowID, wxBitmapBundle> m_toolNormalBitmaps;
-    std::map<wxWindowID, wxBitmapBundle> m_toolCheckedBitmaps;
-    std::map<wxWindowID, wxString> m_toolNormalTooltips;
-    std::map<wxWindowID, wxString> m_toolCheckedTooltips;
-    std::map<wxWindowID, bool> m_toolStates; // Stores the checked state for check tools
+    std::vector<ToolRecord> m_tools;
+    int m_hoverTool = -1;    //index of the tool under the mouse, or -1
+    int m_pressedTool = -1;  //index of the tool where the left button was pressed, or -1
     int m_nextButtonX;      //x position for next button to add. Does not include padding
     int m_buttonPadding;     //padding around buttons and between them
+    wxString m_hudText;      //diagnostics HUD text. Empty when not displayed
+    IconLoader m_iconLoader;
 };
 
 
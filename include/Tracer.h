@@ -0,0 +1,77 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//std
+#include <atomic>
+#include <chrono>
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+//Tracer records the begin and end time, and the thread, of the scopes marked with
+//TRACE_SCOPE(name), and writes them to a trace event JSON file that can be opened with
+//Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+//Tracing is enabled at runtime, with option --trace=<file> or environment variable
+//AGRILLA_TRACE=<file>, and the file is written when tracing stops. When not enabled,
+//the cost of a traced scope is the test of an atomic flag.
+//Names must be string literals: only the pointer is stored.
+//---------------------------------------------------------------------------------------
+class Tracer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static bool start(const wxString& filename);
+    static void stop();     //writes the file
+
+    static inline bool is_enabled() { return m_fEnabled.load(std::memory_order_relaxed); }
+    static void add_event(const char* name, Clock::time_point begin, Clock::time_point end);
+
+private:
+    static std::atomic<bool> m_fEnabled;
+};
+
+//---------------------------------------------------------------------------------------
+//Records the duration of a scope in the Tracer, if enabled
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        : m_name(Tracer::is_enabled() ? name : nullptr)
+    {
+        if (m_name)
+            m_begin = Tracer::Clock::now();
+    }
+
+    ~TraceScope()
+    {
+        if (m_name)
+            Tracer::add_event(m_name, m_begin, Tracer::Clock::now());
+    }
+
+private:
+    const char* m_name;
+    Tracer::Clock::time_point m_begin;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) agrilla::TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+
+} // namespace agrilla
@@ -0,0 +1,112 @@
+#! /bin/bash
+#------------------------------------------------------------------------------
+# Script to build and run the agrilla_bench benchmark under a local Xvfb
+# server, so that it does not depend on the user display.
+# This script MUST BE RUN from <root>/scripts/ folder
+#
+# usage:
+#   cd scripts
+#   ./run-benchmark.sh [-q] [-s]
+#
+# Results are saved in <root>/z_bench-area/bench-results.json and compared
+# with <root>/z_bench-area/bench-baseline.json. If the baseline does not
+# exist, the results are saved as baseline.
+#------------------------------------------------------------------------------
+
+#------------------------------------------------------------------------------
+# Display the help message
+function DisplayHelp()
+{
+    echo "Usage: ./run-benchmark.sh [option]*"
+    echo ""
+    echo "Options:"
+    echo "    -h --help            Print this help text."
+    echo "    -q --quick           Measure only a few sizes and grid options."
+    echo "    -s --save-baseline   Save the results as the new baseline."
+    echo ""
+}
+
+#------------------------------------------------------------------------------
+# main line starts here
+
+E_SUCCESS=0         # success
+E_BADPATH=66        # not running from <root>/scripts
+E_BUIL_ERROR=68
+E_NO_XVFB=69
+
+enhanced="\e[7m"
+reset="\e[0m"
+
+#get current directory and check we are running from <root>/scripts.
+#For this I just check that "src" folder exists
+scripts_path="${PWD}"
+root_path=$(dirname "${PWD}")
+if [[ ! -e "${root_path}/src" ]]; then
+    echo "Error: not running from <root>/scripts"
+    exit $E_BADPATH
+fi
+
+#parse command line parameters
+bench_options=""
+fSaveBaseline=0
+while [[ $# -gt 0 ]]
+do
+    key="$1"
+
+    case $key in
+        -h|--help)
+        DisplayHelp
+        exit 1
+        ;;
+        -q|--quick)
+        bench_options="${bench_options} --quick"
+        shift       # past argument
+        ;;
+        -s|--save-baseline)
+        fSaveBaseline=1
+        shift       # past argument
+        ;;
+        *) # unknown option
+        DisplayHelp
+        exit 1
+        ;;
+    esac
+done
+
+if ! command -v Xvfb > /dev/null; then
+    echo "Error: Xvfb not found. Install it (e.g. 'sudo apt-get install xvfb')"
+    exit $E_NO_XVFB
+fi
+
+#build the benchmark
+build_path="${root_path}/z_bench-area"
+mkdir -p "${build_path}"
+cd "${build_path}" || exit $E_BADPATH
+echo -e "${enhanced}Building agrilla_bench${reset}"
+cmake -G "Unix Makefiles" -DCMAKE_BUILD_TYPE=Release -DAGRILLA_BUILD_BENCHMARK=ON "${root_path}" > /dev/null || exit $E_BUIL_ERROR
+num_jobs=`getconf _NPROCESSORS_ONLN`
+make -j$num_jobs agrilla_bench || exit $E_BUIL_ERROR
+
+#start a local X server, big enough for the largest size (7680x4320 + toolbar)
+display_num=99
+Xvfb :${display_num} -screen 0 7800x4500x24 -nolisten tcp > /dev/null 2>&1 &
+xvfb_pid=$!
+trap "kill ${xvfb_pid} 2> /dev/null" EXIT
+sleep 1
+
+#run the benchmark
+results="${build_path}/bench-results.json"
+baseline="${build_path}/bench-baseline.json"
+if [[ -e "${baseline}" && "$fSaveBaseline" -eq 0 ]]; then
+    bench_options="${bench_options} --baseline=${baseline}"
+else
+    bench_options="${bench_options} --save-baseline=${baseline}"
+fi
+
+echo -e "${enhanced}Running agrilla_bench${reset}"
+DISPLAY=:${display_num} ./agrilla_bench --output="${results}" ${bench_options}
+exit_code=$?
+echo "Results saved in ${results}"
+
+cd "${scripts_path}" || exit $E_BADPATH
+exit $exit_code
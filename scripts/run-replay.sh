@@ -0,0 +1,105 @@
+#! /bin/bash
+#------------------------------------------------------------------------------
+# Script to build AGrilla and replay a recording of mouse and tool events
+# under a local Xvfb server, so that it does not depend on the user display.
+# This script MUST BE RUN from <root>/scripts/ folder
+#
+# usage:
+#   cd scripts
+#   ./run-replay.sh [-m] <recording-file>
+#
+# Recordings are made running 'agrilla --record=<recording-file>'.
+# The report is printed to stdout.
+#------------------------------------------------------------------------------
+
+#------------------------------------------------------------------------------
+# Display the help message
+function DisplayHelp()
+{
+    echo "Usage: ./run-replay.sh [option]* <recording-file>"
+    echo ""
+    echo "Options:"
+    echo "    -h --help            Print this help text."
+    echo "    -m --max-speed       Replay as fast as possible, not at the original speed."
+    echo ""
+}
+
+#------------------------------------------------------------------------------
+# main line starts here
+
+E_SUCCESS=0         # success
+E_BADPATH=66        # not running from <root>/scripts
+E_BUIL_ERROR=68
+E_NO_XVFB=69
+
+enhanced="\e[7m"
+reset="\e[0m"
+
+#get current directory and check we are running from <root>/scripts.
+#For this I just check that "src" folder exists
+scripts_path="${PWD}"
+root_path=$(dirname "${PWD}")
+if [[ ! -e "${root_path}/src" ]]; then
+    echo "Error: not running from <root>/scripts"
+    exit $E_BADPATH
+fi
+
+#parse command line parameters
+speed="original"
+recording=""
+while [[ $# -gt 0 ]]
+do
+    key="$1"
+
+    case $key in
+        -h|--help)
+        DisplayHelp
+        exit 1
+        ;;
+        -m|--max-speed)
+        speed="max"
+        shift       # past argument
+        ;;
+        *) # the recording
+        recording=$(realpath "$1")
+        shift       # past argument
+        ;;
+    esac
+done
+
+if [[ ! -e "${recording}" ]]; then
+    DisplayHelp
+    exit 1
+fi
+
+if ! command -v Xvfb > /dev/null; then
+    echo "Error: Xvfb not found. Install it (e.g. 'sudo apt-get install xvfb')"
+    exit $E_NO_XVFB
+fi
+
+#build the program
+build_path="${root_path}/z_bench-area"
+mkdir -p "${build_path}"
+cd "${build_path}" || exit $E_BADPATH
+echo -e "${enhanced}Building agrilla${reset}"
+cmake -G "Unix Makefiles" -DCMAKE_BUILD_TYPE=Release "${root_path}" > /dev/null || exit $E_BUIL_ERROR
+num_jobs=`getconf _NPROCESSORS_ONLN`
+make -j$num_jobs agrilla || exit $E_BUIL_ERROR
+
+#start a local X server
+display_num=99
+Xvfb :${display_num} -screen 0 7800x4500x24 -nolisten tcp > /dev/null 2>&1 &
+xvfb_pid=$!
+trap "kill ${xvfb_pid} 2> /dev/null" EXIT
+sleep 1
+
+#replay the recording. Use an empty home folder, so that the user preferences
+#are not used nor modified
+echo -e "${enhanced}Replaying ${recording}${reset}"
+replay_home="${build_path}/replay-home"
+rm -rf "${replay_home}" && mkdir -p "${replay_home}"
+HOME="${replay_home}" DISPLAY=:${display_num} ./agrilla --replay="${recording}" --replay-speed=${speed}
+exit_code=$?
+
+cd "${scripts_path}" || exit $E_BADPATH
+exit $exit_code
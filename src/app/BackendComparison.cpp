@@ -0,0 +1,151 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//wxWidgets
+#include <wx/dcmemory.h>
+
+//agrilla
+#include "BackendComparison.h"
+#include "GridLayout.h"
+
+//std
+#include <algorithm>
+#include <chrono>
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+BackendComparison::BackendComparison(const LayerColours& colours, int repeat)
+    : m_colours(colours)
+    , m_repeat(std::max(repeat, 1))
+{
+}
+
+//---------------------------------------------------------------------------------------
+wxString BackendComparison::run()
+{
+    //the same states for all backends: from a small window with few lines to a 4K
+    //window with many lines
+    static const State states[] = {
+        { 400, 300, 3 },
+        { 1920, 1080, 10 },
+        { 3840, 2160, 100 },
+    };
+
+    wxArrayString names = PaintBackend::get_names();
+    wxString report;
+    for (const State& state : states)
+    {
+        build_state(state);
+        wxImage reference;
+        for (const wxString& name : names)
+        {
+            std::unique_ptr<PaintBackend> pBackend(PaintBackend::create(name, m_resources));
+            wxBitmap bitmap(state.width, state.height, 24);
+            double ms = paint_median_ms(*pBackend, bitmap);
+
+            //the output of the last repetition is compared with the reference
+            wxImage image = bitmap.ConvertToImage();
+            long diff = 0;
+            if (!reference.IsOk())
+                reference = image;
+            else
+                diff = count_diff_pixels(reference, image);
+
+            //memory is only reported by the backends owning pixel buffers
+            wxString memory;
+            if (pBackend->has_buffers())
+            {
+                memory = wxString::Format(" kb=%lu",
+                    (unsigned long)((pBackend->get_memory_bytes() + 1023) / 1024));
+            }
+            report += wxString::Format(
+                "paint_backend name=%s state=%dx%d/%d ms=%.3f%s diff_pixels=%ld\n",
+                name, state.width, state.height, state.segments, ms, memory, diff);
+        }
+    }
+    return report.Trim();
+}
+
+//---------------------------------------------------------------------------------------
+void BackendComparison::build_state(const State& state)
+{
+    GridLayoutOptions options;
+    options.width = state.width;
+    options.height = state.height;
+    options.toolbarHeight = 53;
+    options.fFrame = true;
+    options.frameThickness = 40;
+    options.gridSize = state.segments;
+
+    GridLayout layout;
+    layout.update(options);
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        m_layers[i].fDirty = true;
+    }
+    LayerBuilder::build_dirty_layers(layout, m_colours, m_layers);
+}
+
+//---------------------------------------------------------------------------------------
+double BackendComparison::paint_median_ms(PaintBackend& backend, wxBitmap& bitmap)
+{
+    //Paints the whole bitmap m_repeat times and returns the median time, in
+    //milliseconds. The bitmap is cleared to black before each paint, as the pixels
+    //outside the shape are not painted
+    wxMemoryDC dc(bitmap);
+    wxRegion damaged(0, 0, bitmap.GetWidth(), bitmap.GetHeight());
+    dc.SetBackground(*wxBLACK_BRUSH);
+
+    std::vector<double> times;
+    for (int i = 0; i < m_repeat; ++i)
+    {
+        dc.Clear();
+        auto start = std::chrono::steady_clock::now();
+        backend.paint(dc, m_layers, damaged, 255);
+        auto end = std::chrono::steady_clock::now();
+        times.push_back( std::chrono::duration<double, std::milli>(end - start).count() );
+    }
+    dc.SelectObject(wxNullBitmap);
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+//---------------------------------------------------------------------------------------
+long BackendComparison::count_diff_pixels(const wxImage& reference, const wxImage& image)
+{
+    if (reference.GetWidth() != image.GetWidth()
+        || reference.GetHeight() != image.GetHeight())
+    {
+        return long(reference.GetWidth()) * reference.GetHeight();
+    }
+
+    const unsigned char* pRef = reference.GetData();
+    const unsigned char* pData = image.GetData();
+    long numPixels = long(reference.GetWidth()) * reference.GetHeight();
+    long diff = 0;
+    for (long i = 0; i < numPixels; ++i, pRef += 3, pData += 3)
+    {
+        if (pRef[0] != pData[0] || pRef[1] != pData[1] || pRef[2] != pData[2])
+            ++diff;
+    }
+    return diff;
+}
+
+
+} // namespace agrilla
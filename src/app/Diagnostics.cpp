@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "Diagnostics.h"
+
+//std
+#include <algorithm>
+
+
+namespace agrilla
+{
+
+//definition required, as std::min() takes it by reference
+const int Diagnostics::k_samples;
+
+//---------------------------------------------------------------------------------------
+void Diagnostics::enable(bool value)
+{
+    //start with empty statistics, so that old values are not displayed
+    m_fEnabled = value;
+    for (int i = 0; i < k_diag_counter_max; ++i)
+    {
+        m_counts[i] = 0;
+    }
+    for (int i = 0; i < k_diag_duration_max; ++i)
+    {
+        m_durations[i] = DurationSamples();
+    }
+    m_lastSample = std::chrono::steady_clock::now();
+}
+
+//---------------------------------------------------------------------------------------
+void Diagnostics::add_duration(EDiagDuration what, double ms)
+{
+    DurationSamples& samples = m_durations[what];
+    samples.values[samples.next] = ms;
+    samples.next = (samples.next + 1) % k_samples;
+    samples.size = std::min(samples.size + 1, k_samples);
+    samples.last = ms;
+}
+
+//---------------------------------------------------------------------------------------
+double Diagnostics::get_p99(EDiagDuration what) const
+{
+    //p99 of the last k_samples durations
+    const DurationSamples& samples = m_durations[what];
+    if (samples.size == 0)
+        return 0.0;
+
+    double values[k_samples];
+    std::copy(samples.values, samples.values + samples.size, values);
+    int index = std::min((samples.size * 99) / 100, samples.size - 1);
+    std::nth_element(values, values + index, values + samples.size);
+    return values[index];
+}
+
+//---------------------------------------------------------------------------------------
+wxString Diagnostics::sample()
+{
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - m_lastSample).count();
+    m_lastSample = now;
+    if (seconds <= 0.0)
+        seconds = 1.0;
+
+    double rates[k_diag_counter_max];
+    for (int i = 0; i < k_diag_counter_max; ++i)
+    {
+        rates[i] = m_counts[i] / seconds;
+        m_counts[i] = 0;
+    }
+
+    return wxString::Format("paint %.0f/s  shape %.0f/s  motion %.0f/s\n"
+                            "draw %.1f ms (p99 %.1f)  shape %.1f ms (p99 %.1f)",
+                            rates[k_diag_paints], rates[k_diag_shapes], rates[k_diag_motion],
+                            m_durations[k_diag_draw].last, get_p99(k_diag_draw),
+                            m_durations[k_diag_set_shape].last, get_p99(k_diag_set_shape));
+}
+
+
+} // namespace agrilla
@@ -0,0 +1,63 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//wxWidgets
+#include <wx/filename.h>
+#include <wx/log.h>
+
+//agrilla
+#include "EmbeddedResources.h"
+
+
+//log messages from this file belong to the 'agrilla/app' module
+#define wxLOG_COMPONENT "agrilla/app"
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+const EmbeddedResource* EmbeddedResources::find(const wxString& name)
+{
+    for (const EmbeddedResource* pRes = k_embedded_resources; pRes->name; ++pRes)
+    {
+        if (name == pRes->name)
+            return pRes;
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+wxBitmapBundle EmbeddedResources::get_svg_icon(const wxString& name, const wxSize& size,
+                                               const wxString& overrideDir)
+{
+    if (!overrideDir.IsEmpty())
+    {
+        wxFileName file(overrideDir, name);
+        if (file.FileExists())
+            return wxBitmapBundle::FromSVGFile(file.GetFullPath(), size);
+    }
+
+    const EmbeddedResource* pRes = find(name);
+    if (!pRes)
+    {
+        wxLogError("[EmbeddedResources::get_svg_icon] Icon '%s' is not embedded", name);
+        return wxBitmapBundle();
+    }
+    return wxBitmapBundle::FromSVG(pRes->data, pRes->size, size);
+}
+
+
+} // namespace agrilla
@@ -0,0 +1,217 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+//agrilla
+#include "GridLayout.h"
+
+//std
+#include <cmath>
+
+
+namespace agrilla
+{
+
+const double GOLDEN_RATIO = 1.618033988749;
+
+//---------------------------------------------------------------------------------------
+bool GridLayoutOptions::operator ==(const GridLayoutOptions& o) const
+{
+    return width == o.width && height == o.height
+        && toolbarHeight == o.toolbarHeight
+        && fFrame == o.fFrame && frameThickness == o.frameThickness
+        && fGrid == o.fGrid && gridSize == o.gridSize
+        && lineThickness == o.lineThickness
+        && fGoldenLines == o.fGoldenLines
+        && fHandlers == o.fHandlers && handlerSide == o.handlerSide;
+}
+
+
+//=======================================================================================
+// GridLayout implementation
+//=======================================================================================
+bool GridLayout::update(const GridLayoutOptions& options)
+{
+    if (m_fValid && options == m_options)
+        return false;
+
+    m_options = options;
+    compute();
+    m_fValid = true;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void GridLayout::compute()
+{
+    const GridLayoutOptions& o = m_options;
+
+    m_toolbarRect = LayoutRect(0, 0, o.width, o.toolbarHeight);
+    m_clientRect = LayoutRect(0, o.toolbarHeight, o.width, o.height - o.toolbarHeight);
+
+    m_gridRect = m_clientRect;
+    if (o.fFrame)
+        m_gridRect = m_clientRect.inflated(-o.frameThickness);
+
+    compute_frame_bands();
+    compute_grid_lines();
+    compute_golden_lines();
+    compute_border_lines();
+    compute_handles();
+}
+
+//---------------------------------------------------------------------------------------
+void GridLayout::compute_frame_bands()
+{
+    //the frame is the client area minus the grid area: four bands
+    m_frameBands.clear();
+    if (!m_options.fFrame)
+        return;
+
+    const LayoutRect& client = m_clientRect;
+    const LayoutRect& grid = m_gridRect;
+    int gridBottom = grid.get_bottom() + 1;
+    int gridRight = grid.get_right() + 1;
+
+    m_frameBands.emplace_back(client.x, client.y, client.width, grid.y - client.y);
+    m_frameBands.emplace_back(client.x, gridBottom, client.width, client.get_bottom() + 1 - gridBottom);
+    m_frameBands.emplace_back(client.x, grid.y, grid.x - client.x, grid.height);
+    m_frameBands.emplace_back(gridRight, grid.y, client.get_right() + 1 - gridRight, grid.height);
+}
+
+//---------------------------------------------------------------------------------------
+void GridLayout::compute_grid_lines()
+{
+    m_gridLines.clear();
+    int gridSize = m_options.gridSize;
+    if (!m_options.fGrid || gridSize <= 1)
+        return;
+
+    int width = m_gridRect.width;
+    int height = m_gridRect.height;
+    int left = m_gridRect.x;
+    int top = m_gridRect.y;
+
+    m_gridLines.reserve(2 * (gridSize - 1));
+
+    // Vertical lines
+    for (int i = 1; i < gridSize; ++i)
+    {
+        int x = ((width * i) / gridSize) + left;
+        m_gridLines.push_back( vertical_line(x, top, height) );
+    }
+    // Horizontal lines
+    for (int i = 1; i < gridSize; ++i)
+    {
+        int y = ((height * i) / gridSize) + top;
+        m_gridLines.push_back( horizontal_line(left, y, width) );
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GridLayout::compute_golden_lines()
+{
+    m_goldenLines.clear();
+    if (!m_options.fGoldenLines)
+        return;
+
+    int width = m_gridRect.width;
+    int height = m_gridRect.height;
+    int left = m_gridRect.x;
+    int top = m_gridRect.y;
+
+    //calculate golden ratio segments for width and height
+    int golden_width_b = static_cast<int>(std::round(width / GOLDEN_RATIO));
+    int golden_height_b = static_cast<int>(std::round(height / GOLDEN_RATIO));
+
+    //vertical golden lines
+    m_goldenLines.push_back( vertical_line(golden_width_b + left, top, height) );
+    m_goldenLines.push_back( vertical_line(left + width - golden_width_b, top, height) );
+
+    //horizontal golden lines
+    m_goldenLines.push_back( horizontal_line(left, golden_height_b + top, width) );
+    m_goldenLines.push_back( horizontal_line(left, top + height - golden_height_b, width) );
+}
+
+//---------------------------------------------------------------------------------------
+void GridLayout::compute_border_lines()
+{
+    // The border around the grid: four lines centered on the grid rectangle edges
+
+    int lineThickness = m_options.lineThickness;
+    int halfLine = lineThickness / 2;
+    int width = m_gridRect.width + lineThickness - 1;
+    int height = m_gridRect.height + lineThickness - 1;
+    int left = m_gridRect.x - halfLine;
+    int top = m_gridRect.y - halfLine;
+
+    m_borderLines.clear();
+    m_borderLines.push_back( horizontal_line(left, m_gridRect.y, width) );
+    m_borderLines.push_back( horizontal_line(left, m_gridRect.get_bottom(), width) );
+    m_borderLines.push_back( vertical_line(m_gridRect.x, top, height) );
+    m_borderLines.push_back( vertical_line(m_gridRect.get_right(), top, height) );
+}
+
+//---------------------------------------------------------------------------------------
+void GridLayout::compute_handles()
+{
+    m_handles.clear();
+    if (!m_options.fHandlers)
+        return;
+
+    const LayoutRect& grid = m_gridRect;
+    int side = m_options.handlerSide;
+    int halfHandle = (side - m_options.lineThickness) / 2;
+    int middleX = grid.x + grid.width / 2 - halfHandle;
+    int middleY = grid.y + grid.height / 2 - halfHandle;
+
+    m_handles.resize(k_handle_max);
+    m_handles[k_handle_right] = LayoutRect(grid.get_right() - side, middleY, side, side);
+    m_handles[k_handle_left] = LayoutRect(grid.x, middleY, side, side);
+    m_handles[k_handle_top] = LayoutRect(middleX, grid.y, side, side);
+    m_handles[k_handle_bottom] = LayoutRect(middleX, grid.get_bottom() - side, side, side);
+}
+
+//---------------------------------------------------------------------------------------
+EGridZone GridLayout::hit_test(int x, int y) const
+{
+    if (!m_gridRect.contains(x, y))
+        return k_zone_outside;
+
+    if (!m_handles.empty())
+    {
+        if (m_handles[k_handle_right].contains(x, y))
+            return k_zone_handle_right;
+        if (m_handles[k_handle_left].contains(x, y))
+            return k_zone_handle_left;
+        if (m_handles[k_handle_top].contains(x, y))
+            return k_zone_handle_top;
+        if (m_handles[k_handle_bottom].contains(x, y))
+            return k_zone_handle_bottom;
+    }
+    return k_zone_grid;
+}
+
+//---------------------------------------------------------------------------------------
+LayoutRect GridLayout::vertical_line(int x, int top, int height) const
+{
+    //the rectangle covered by a vertical line of lineThickness pixels, centered on x
+    int thickness = m_options.lineThickness;
+    return LayoutRect(x - thickness / 2, top, thickness, height);
+}
+
+//---------------------------------------------------------------------------------------
+LayoutRect GridLayout::horizontal_line(int left, int y, int width) const
+{
+    //the rectangle covered by an horizontal line of lineThickness pixels, centered on y
+    int thickness = m_options.lineThickness;
+    return LayoutRect(left, y - thickness / 2, width, thickness);
+}
+
+
+} // namespace agrilla
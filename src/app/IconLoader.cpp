@@ -0,0 +1,111 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "IconLoader.h"
+#include "EmbeddedResources.h"
+#include "Tracer.h"
+
+//std
+#include <algorithm>
+
+
+namespace agrilla
+{
+
+//definition required, as std::min() takes it by reference
+const int IconLoader::k_max_workers;
+
+//---------------------------------------------------------------------------------------
+IconLoader::IconLoader(wxEvtHandler* pOwner, const wxSize& size,
+                       const wxString& overrideDir)
+    : m_pOwner(pOwner)
+    , m_size(size)
+    , m_overrideDir(overrideDir)
+{
+    int workers = std::min(int(std::thread::hardware_concurrency()), k_max_workers);
+    for (int i = 0; i < std::max(workers, 1); ++i)
+        m_workers.push_back(std::thread(&IconLoader::worker_thread, this));
+}
+
+//---------------------------------------------------------------------------------------
+IconLoader::~IconLoader()
+{
+    stop();
+}
+
+//---------------------------------------------------------------------------------------
+void IconLoader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fStop = true;
+        m_requests.clear();
+    }
+    m_cv.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void IconLoader::request(int id, int variant, const wxString& name)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fStop)
+            return;
+        m_requests.push_back({ id, variant, name });
+    }
+    m_cv.notify_one();
+}
+
+//---------------------------------------------------------------------------------------
+void IconLoader::worker_thread()
+{
+    //AWARE: wxBitmap can only be used in the main thread. But creating the bundle
+    //does not create any bitmap, it only parses the SVG data.
+
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_fStop || !m_requests.empty(); });
+            if (m_fStop)
+                return;
+            request = m_requests.front();
+            m_requests.pop_front();
+        }
+
+        //the bundle is not thread safe: when the event is queued, only the payload
+        //must hold a reference to it
+        TRACE_SCOPE("IconLoader::load_icon");
+        wxThreadEvent* pEvent = new wxThreadEvent(wxEVT_THREAD, request.id);
+        pEvent->SetInt(request.variant);
+        {
+            wxBitmapBundle bundle = EmbeddedResources::get_svg_icon(request.name, m_size,
+                                                                    m_overrideDir);
+            pEvent->SetPayload(bundle);
+        }
+        m_pOwner->QueueEvent(pEvent);
+    }
+}
+
+
+} // namespace agrilla
@@ -0,0 +1,200 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "InputReplay.h"
+#include "MainFrame.h"
+
+//std
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+
+//log messages from this file belong to the 'agrilla/replay' module
+#define wxLOG_COMPONENT "agrilla/replay"
+
+
+namespace agrilla
+{
+
+//=======================================================================================
+// InputRecorder implementation
+//=======================================================================================
+void InputRecorder::start(const wxString& filename, const wxRect& frameRect)
+{
+    m_filename = filename;
+    m_frameRect = frameRect;
+    m_events.clear();
+    m_events.reserve(16 * 1024);
+    m_start = Clock::now();
+    m_fRecording = true;
+    wxLogMessage("[InputRecorder::start] Recording input to file '%s'", filename);
+}
+
+//---------------------------------------------------------------------------------------
+void InputRecorder::add(EInputKind kind, const wxPoint& pos, int flags)
+{
+    long long time = std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - m_start).count();
+    m_events.push_back({ time, static_cast<char>(kind), pos.x, pos.y, flags });
+}
+
+//---------------------------------------------------------------------------------------
+void InputRecorder::stop()
+{
+    if (!m_fRecording)
+        return;
+    m_fRecording = false;
+
+    std::ofstream file(m_filename.fn_str(), std::ios::trunc);
+    file << "agrilla-input 1 " << m_frameRect.x << " " << m_frameRect.y << " "
+         << m_frameRect.width << " " << m_frameRect.height << "\n";
+    for (const InputEvent& event : m_events)
+    {
+        file << event.time << " " << event.kind << " " << event.x << " " << event.y
+             << " " << event.flags << "\n";
+    }
+    file.close();
+
+    if (!file)
+        wxLogError("[InputRecorder::stop] Could not write file '%s'", m_filename);
+    else
+        wxLogMessage("[InputRecorder::stop] %d events written to '%s'",
+                     int(m_events.size()), m_filename);
+}
+
+
+//=======================================================================================
+// InputReplay implementation
+//=======================================================================================
+InputReplay::InputReplay(MainFrame* pFrame, bool fMaxSpeed)
+    : m_pFrame(pFrame)
+    , m_fMaxSpeed(fMaxSpeed)
+{
+}
+
+//---------------------------------------------------------------------------------------
+bool InputReplay::load(const wxString& filename)
+{
+    std::ifstream file(filename.fn_str());
+    std::string magic;
+    int version = 0;
+    file >> magic >> version >> m_frameRect.x >> m_frameRect.y >> m_frameRect.width
+         >> m_frameRect.height;
+    if (!file || magic != "agrilla-input" || version != 1)
+    {
+        wxLogError("[InputReplay::load] '%s' is not an input recording", filename);
+        return false;
+    }
+
+    m_events.clear();
+    InputEvent event;
+    while (file >> event.time >> event.kind >> event.x >> event.y >> event.flags)
+    {
+        m_events.push_back(event);
+    }
+    wxLogMessage("[InputReplay::load] %d events loaded from '%s'", int(m_events.size()),
+                 filename);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void InputReplay::wait_until(Clock::time_point time)
+{
+    //pending paint and timer events are processed while waiting
+    do
+    {
+        wxTheApp->Yield(true);
+        if (Clock::now() < time)
+            wxMilliSleep(1);
+    }
+    while (Clock::now() < time);
+}
+
+//---------------------------------------------------------------------------------------
+const char* InputReplay::get_kind_name(char kind)
+{
+    switch (kind)
+    {
+        case k_input_left_down:     return "left_down";
+        case k_input_motion:        return "motion";
+        case k_input_left_up:       return "left_up";
+        case k_input_left_dclick:   return "left_dclick";
+        case k_input_tool:          return "tool";
+        default:
+            return "unknown";
+    }
+}
+
+//---------------------------------------------------------------------------------------
+wxString InputReplay::run()
+{
+    //start from the recorded geometry, as the effect of the mouse events depends on it
+    m_pFrame->SetSize(m_frameRect);
+    wait_until(Clock::now() + std::chrono::milliseconds(200));
+
+    const Diagnostics& diag = m_pFrame->get_diagnostics();
+    unsigned long long totals[k_diag_counter_max];
+    for (int i = 0; i < k_diag_counter_max; ++i)
+    {
+        totals[i] = diag.get_total(EDiagCounter(i));
+    }
+
+    std::map<char, std::vector<double> > latencies;
+    Clock::time_point start = Clock::now();
+    for (const InputEvent& event : m_events)
+    {
+        if (!m_fMaxSpeed)
+            wait_until(start + std::chrono::microseconds(event.time));
+
+        Clock::time_point begin = Clock::now();
+        m_pFrame->replay_input(event);
+        wxTheApp->Yield(true);
+        latencies[event.kind].push_back(
+            std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+    }
+    double total = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    //rebuilds are the layers built in the main thread. Restores from the cache and
+    //builds in the render thread are counted apart
+    wxString report = wxString::Format(
+        "replay events=%d total_ms=%.2f paints=%llu rebuilds=%llu cache_restores=%llu "
+        "background_builds=%llu shapes=%llu",
+        int(m_events.size()), total,
+        diag.get_total(k_diag_paints) - totals[k_diag_paints],
+        diag.get_total(k_diag_rebuilds) - totals[k_diag_rebuilds],
+        diag.get_total(k_diag_cache_restores) - totals[k_diag_cache_restores],
+        diag.get_total(k_diag_background) - totals[k_diag_background],
+        diag.get_total(k_diag_shapes) - totals[k_diag_shapes]);
+    report += "\n" + m_pFrame->get_drag_latency().get_report("drag");
+    for (auto& item : latencies)
+    {
+        std::vector<double>& values = item.second;
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (double value : values)
+            sum += value;
+        size_t n = values.size();
+        report += wxString::Format("\nreplay_latency kind=%s n=%d mean_ms=%.3f p50_ms=%.3f "
+                                   "p99_ms=%.3f max_ms=%.3f", get_kind_name(item.first),
+                                   int(n), sum / n, values[n / 2],
+                                   values[std::min(n * 99 / 100, n - 1)], values.back());
+    }
+    return report;
+}
+
+
+} // namespace agrilla
@@ -0,0 +1,109 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "LatencyHistogram.h"
+
+//std
+#include <algorithm>
+#include <cmath>
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+//---------------------------------------------------------------------------------------
+void LatencyHistogram::reset()
+{
+    std::fill(m_counts, m_counts + k_num_buckets, 0u);
+    m_count = 0;
+    m_max = 0;
+}
+
+//---------------------------------------------------------------------------------------
+int LatencyHistogram::get_bucket(long long value)
+{
+    //Values below k_sub_buckets are their own bucket. For bigger values, the bucket
+    //is given by the position of the highest bit and the k_sub_bits after it
+
+    if (value < k_sub_buckets)
+        return static_cast<int>(std::max(value, 0LL));
+
+    value = std::min(value, (1LL << k_max_bit) - 1);
+    int highest = k_sub_bits;
+    while ((value >> (highest + 1)) != 0)
+        ++highest;
+
+    int shift = highest - k_sub_bits;
+    int sub = static_cast<int>(value >> shift) & (k_sub_buckets - 1);
+    return k_sub_buckets * (shift + 1) + sub;
+}
+
+//---------------------------------------------------------------------------------------
+long long LatencyHistogram::get_bucket_limit(int bucket)
+{
+    //the highest value counted in the bucket
+    if (bucket < k_sub_buckets)
+        return bucket;
+
+    int shift = bucket / k_sub_buckets - 1;
+    long long sub = bucket % k_sub_buckets;
+    long long lowest = (k_sub_buckets + sub) << shift;
+    return lowest + (1LL << shift) - 1;
+}
+
+//---------------------------------------------------------------------------------------
+void LatencyHistogram::record(long long microseconds)
+{
+    ++m_counts[get_bucket(microseconds)];
+    ++m_count;
+    m_max = std::max(m_max, microseconds);
+}
+
+//---------------------------------------------------------------------------------------
+long long LatencyHistogram::get_percentile(double percentile) const
+{
+    if (m_count == 0)
+        return 0;
+
+    long long target = static_cast<long long>(std::ceil(percentile / 100.0 * m_count));
+    target = std::max(target, 1LL);
+    long long accumulated = 0;
+    for (int i = 0; i < k_num_buckets; ++i)
+    {
+        accumulated += m_counts[i];
+        if (accumulated >= target)
+            return std::min(get_bucket_limit(i), m_max);
+    }
+    return m_max;
+}
+
+//---------------------------------------------------------------------------------------
+wxString LatencyHistogram::get_report(const char* name) const
+{
+    return wxString::Format("latency_ms name=%s n=%lld p50=%.2f p95=%.2f p99=%.2f max=%.2f",
+                            name, m_count, get_percentile(50.0) / 1000.0,
+                            get_percentile(95.0) / 1000.0, get_percentile(99.0) / 1000.0,
+                            m_max / 1000.0);
+}
+
+
+} // namespace agrilla
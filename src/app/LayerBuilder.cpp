@@ -0,0 +1,131 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "LayerBuilder.h"
+#include "Tracer.h"
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+inline wxRect to_wx_rect(const LayoutRect& rect)
+{
+    return wxRect(rect.x, rect.y, rect.width, rect.height);
+}
+
+//---------------------------------------------------------------------------------------
+void LayerBuilder::build_dirty_layers(const GridLayout& layout, const LayerColours& colours,
+                                      RenderLayer* pLayers)
+{
+    TRACE_SCOPE("LayerBuilder::build_dirty_layers");
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        RenderLayer& layer = pLayers[i];
+        if (!layer.fDirty)
+            continue;
+
+        layer.rects.clear();
+        switch (i)
+        {
+            case k_layer_toolbar:
+                build_toolbar_layer(layout, make_colour(colours.toolbar), layer);
+                break;
+            case k_layer_frame:
+                //the frame is the client area minus the grid area: four bands
+                add_layout_rects(layer, layout.get_frame_bands(), make_colour(colours.frame));
+                break;
+            case k_layer_grid:
+                add_layout_rects(layer, layout.get_grid_lines(),
+                                 make_colour(colours.gridLines));
+                break;
+            case k_layer_golden_lines:
+                add_layout_rects(layer, layout.get_golden_lines(),
+                                 make_colour(colours.goldenLines));
+                break;
+            case k_layer_border:
+                build_border_layer(layout, layer);
+                break;
+        }
+        layer.fDirty = false;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void LayerBuilder::add_to_shape(const RenderLayer* pLayers, std::initializer_list<int> layers,
+                                ShapeBuilder& shape)
+{
+    for (int layer : layers)
+    {
+        for (const FilledRect& filled : pLayers[layer].rects)
+        {
+            shape.add_rect(filled.rect);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void LayerBuilder::build_toolbar_layer(const GridLayout& layout, const wxColour& colour,
+                                       RenderLayer& layer)
+{
+    // The coloured rectangle at the top, for the toolbar.
+    layer.rects.push_back({ to_wx_rect(layout.get_toolbar_rect()), colour });
+}
+
+//---------------------------------------------------------------------------------------
+void LayerBuilder::build_border_layer(const GridLayout& layout, RenderLayer& layer)
+{
+    // A white border around the grid bitmap and the resize handlers on top of it
+    add_layout_rects(layer, layout.get_border_lines(), wxColour(255, 255, 255));
+    build_resize_handlers(layout, layer);
+}
+
+//---------------------------------------------------------------------------------------
+void LayerBuilder::build_resize_handlers(const GridLayout& layout, RenderLayer& layer)
+{
+    //each handle is a white square with a 2 pixels nearly black border (black
+    //cannot be used). The border is a filled square behind the white one
+    wxColour white(255, 255, 255);
+    wxColour nearlyBlack(0, 0, 5);
+    for (const LayoutRect& handle : layout.get_handles())
+    {
+        layer.rects.push_back({ to_wx_rect(handle.inflated(1)), nearlyBlack });
+        layer.rects.push_back({ to_wx_rect(handle.inflated(-1)), white });
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void LayerBuilder::add_layout_rects(RenderLayer& layer, const std::vector<LayoutRect>& rects,
+                                    const wxColour& colour)
+{
+    layer.rects.reserve(layer.rects.size() + rects.size());
+    for (const LayoutRect& rect : rects)
+    {
+        layer.rects.push_back({ to_wx_rect(rect), colour });
+    }
+}
+
+//---------------------------------------------------------------------------------------
+wxColour LayerBuilder::make_colour(uint32_t rgba)
+{
+    //a new colour, not sharing its data with the colours used in other threads
+    wxColour colour;
+    colour.SetRGBA(rgba);
+    return colour;
+}
+
+
+} // namespace agrilla
@@ -19,6 +19,7 @@
 #include <wx/dcclient.h>
 #include <wx/log.h>
 #include <wx/msgdlg.h>
+#include <wx/display.h>
 
 
 //agrilla
@@ -29,17 +30,25 @@
 #include "DlgAspectRatio.h"
 #include "DlgAbout.h"
 #include "ToolBar.h"
+#include "Tracer.h"
 
 //std
 #include <cmath> // For std::abs
+#include <algorithm>
 #include <memory>
 
 
+//log messages from this file belong to the 'agrilla/frame' module
+#define wxLOG_COMPONENT "agrilla/frame"
+
+
 namespace agrilla
 {
 
 const int MIN_CLIENT_DIM = 20; // Minimum client dimension
-const double GOLDEN_RATIO = 1.618033988749;
+const int DEFAULT_REFRESH_RATE = 60;    // Display refresh rate (Hz) when unknown
+const int DRAG_SETTLE_MS = 150;         // Time without changes to consider a drag finished
+const long long BACKGROUND_RENDER_COST = 3840LL * 2160 * 100;  // Area x segments to build in background
 
 enum
 {
@@ -64,30 +73,83 @@ enum
 
     //other
     k_id_toolbar,
+    k_id_drag_timer,
+    k_id_hud_timer,
+    k_id_render,
 
 };
 
 
+
 //=======================================================================================
 // MainFrame implementation
 //=======================================================================================
 MainFrame::MainFrame(const wxSize& initialSize)
-    : wxFrame(nullptr, wxID_ANY, "AGrilla", wxDefaultPosition, initialSize
-    , wxFRAME_SHAPED | wxCLIP_CHILDREN | wxBORDER_NONE | wxSTAY_ON_TOP)
+    : wxFrame()
 {
+    //the background style must be set before creating the window
+    select_overlay_mode();
+    select_paint_backend();
+    if (m_fArgbMode)
+        SetBackgroundStyle(wxBG_STYLE_TRANSPARENT);
+    else
+        SetBackgroundStyle(wxBG_STYLE_PAINT);   //on_paint() paints all the visible pixels
+
+    Create(nullptr, wxID_ANY, "AGrilla", wxDefaultPosition, initialSize
+           , wxFRAME_SHAPED | wxCLIP_CHILDREN | wxBORDER_NONE | wxSTAY_ON_TOP);
+
+    StartupProfile& startup = wxGetApp().get_startup_profile();
+    startup.mark("create_window");
     get_grid_options();
-    create_shaped_frame();
+    startup.mark("grid_options");
+    if (!m_fArgbMode)
+    {
+        create_shaped_frame();
+
+        //expensive states are built in a worker thread
+        bool fBackground = true;
+        wxGetApp().get_preferences()->Read("/Render/BackgroundThread", &fBackground, true);
+        if (fBackground)
+            m_pRenderThread.reset(new RenderThread(this, k_id_render));
+    }
+    startup.mark("shaped_frame");
     create_toolbar();
+    startup.mark("toolbar");
 
     //bind the events
     Bind(wxEVT_PAINT, &MainFrame::on_paint, this);
+    Bind(wxEVT_IDLE, &MainFrame::on_idle, this);
+    Bind(wxEVT_THREAD, &MainFrame::on_render_done, this, k_id_render);
     Bind(wxEVT_LEFT_DOWN, &MainFrame::on_mouse_left_down, this);
     Bind(wxEVT_MOTION, &MainFrame::on_mouse_motion, this);
     Bind(wxEVT_LEFT_UP, &MainFrame::on_mouse_left_up, this);
     Bind(wxEVT_BUTTON, &MainFrame::on_quit, this, k_evt_quit);
+    Bind(wxEVT_LEFT_DCLICK, &MainFrame::on_mouse_left_dclick, this);
+    Bind(wxEVT_TIMER, &MainFrame::on_drag_timer, this, k_id_drag_timer);
+    Bind(wxEVT_TIMER, &MainFrame::on_hud_timer, this, k_id_hud_timer);
+    m_dragTimer.SetOwner(this, k_id_drag_timer);
+    m_hudTimer.SetOwner(this, k_id_hud_timer);
+
+    //the diagnostics HUD can be enabled from the environment
+    wxString hud;
+    if (wxGetEnv("AGRILLA_HUD", &hud) && !hud.IsEmpty() && hud != "0")
+        toggle_hud();
 
 
     Refresh();      //good practice to force an initial paint after setup
+    startup.mark("frame_init");
+}
+
+//---------------------------------------------------------------------------------------
+MainFrame::~MainFrame()
+{
+    //no more results can be sent to this frame
+    m_pRenderThread.reset();
+
+    if (m_dragLatency.get_count() > 0)
+        wxLogMessage("[MainFrame::~MainFrame] %s", m_dragLatency.get_report("drag"));
+    if (m_shapeCache.get_hits() + m_shapeCache.get_misses() > 0)
+        wxLogMessage("[MainFrame::~MainFrame] %s", m_shapeCache.get_report());
 }
 
 //---------------------------------------------------------------------------------------
@@ -100,71 +162,40 @@ void MainFrame::create_toolbar()
         m_toolbar = nullptr;
     }
 
-    // Define indices for the bitmap vector.
-    enum BitmapIndices
-    {
-        k_bmp_grid_options = 0,
-        k_bmp_set_aspect_ratio,
-        k_bmp_unlocked_aspect_ratio,
-        k_bmp_locked_aspect_ratio,
-        k_bmp_show_grid,
-        k_bmp_hide_grid,
-        k_bmp_show_golden_lines,
-        k_bmp_hide_golden_lines,
-        k_bmp_show_frame,
-        k_bmp_hide_frame,
-        k_bmp_about,
-        k_bmp_quit,
-        //
-        k_bmp_max
-    };
-
-    // Create a bitmap bundle from the SVG file
-    wxString sResPath = wxGetApp().get_resources_path();
-    wxLogMessage("[MainFrame::create_toolbar] icons path '%s'", sResPath);
+    // Create the custom toolbar panel. Icons are created in background from the
+    // embedded SVG icons, unless replaced by the icons in the user icons folder
+    wxString sIconsDir = wxGetApp().get_icons_dir();
+    if (!sIconsDir.IsEmpty())
+        wxLogMessage("[MainFrame::create_toolbar] icons folder '%s'", sIconsDir);
     wxSize iconsSize(28,28);
-    wxVector<wxBitmapBundle> bitmaps(k_bmp_max);
-    bitmaps[k_bmp_grid_options] = wxBitmapBundle::FromSVGFile(sResPath + "options.svg", iconsSize);
-    bitmaps[k_bmp_set_aspect_ratio] = wxBitmapBundle::FromSVGFile(sResPath + "set-aspect-ratio.svg", iconsSize);
-    bitmaps[k_bmp_unlocked_aspect_ratio]= wxBitmapBundle::FromSVGFile(sResPath + "aspect-ratio-unlocked.svg", iconsSize);
-    bitmaps[k_bmp_locked_aspect_ratio]= wxBitmapBundle::FromSVGFile(sResPath + "aspect-ratio-locked.svg", iconsSize);
-    bitmaps[k_bmp_show_grid]= wxBitmapBundle::FromSVGFile(sResPath + "grid-on.svg", iconsSize);
-    bitmaps[k_bmp_hide_grid]= wxBitmapBundle::FromSVGFile(sResPath + "grid-off.svg", iconsSize);
-    bitmaps[k_bmp_show_golden_lines]= wxBitmapBundle::FromSVGFile(sResPath + "golden-lines-on.svg", iconsSize);
-    bitmaps[k_bmp_hide_golden_lines]= wxBitmapBundle::FromSVGFile(sResPath + "golden-lines-off.svg", iconsSize);
-    bitmaps[k_bmp_show_frame]= wxBitmapBundle::FromSVGFile(sResPath + "frame-on.svg", iconsSize);
-    bitmaps[k_bmp_hide_frame]= wxBitmapBundle::FromSVGFile(sResPath + "frame-off.svg", iconsSize);
-    bitmaps[k_bmp_about]= wxBitmapBundle::FromSVGFile(sResPath + "about.svg", iconsSize);
-    bitmaps[k_bmp_quit] = wxBitmapBundle::FromSVGFile(sResPath + "shutdown.svg", iconsSize);
-
-    // Create the custom toolbar panel
-    m_toolbar = new ToolBar(this, k_id_toolbar, GetClientSize().GetWidth(), iconsSize, m_toolbarColour);
+    m_toolbar = new ToolBar(this, k_id_toolbar, GetClientSize().GetWidth(), iconsSize,
+                            m_toolbarColour, sIconsDir);
 
     // Add tools using the custom toolbar's methods
-    m_toolbar->add_tool(k_evt_grid_options, bitmaps[k_bmp_grid_options], "Options");
-    m_toolbar->add_tool(k_evt_set_aspect_ratio, bitmaps[k_bmp_set_aspect_ratio], "Set aspect ratio");
+    m_toolbar->add_tool(k_evt_grid_options, "options.svg", "Options");
+    m_toolbar->add_tool(k_evt_set_aspect_ratio, "set-aspect-ratio.svg", "Set aspect ratio");
     m_toolbar->add_check_tool(k_evt_lock_aspect_ratio,
-                            bitmaps[k_bmp_unlocked_aspect_ratio],   // Normal state icon
-                            bitmaps[k_bmp_locked_aspect_ratio],     // Checked state icon
-                            "Lock aspect ratio",                    // Normal state tooltip
-                            "Unlock the aspect ratio");             // Checked state tooltip
+                            "aspect-ratio-unlocked.svg",    // Normal state icon
+                            "aspect-ratio-locked.svg",      // Checked state icon
+                            "Lock aspect ratio",            // Normal state tooltip
+                            "Unlock the aspect ratio");     // Checked state tooltip
     m_toolbar->add_check_tool(k_evt_show_grid,
-                            bitmaps[k_bmp_show_grid],   // Normal state icon
-                            bitmaps[k_bmp_hide_grid],   // Checked state icon
-                            "Hide grid",                // Normal state tooltip
-                            "Show grid");               // Checked state tooltip
+                            "grid-on.svg",      // Normal state icon
+                            "grid-off.svg",     // Checked state icon
+                            "Hide grid",        // Normal state tooltip
+                            "Show grid");       // Checked state tooltip
     m_toolbar->add_check_tool(k_evt_show_golden_lines,
-                            bitmaps[k_bmp_show_golden_lines],   // Normal state icon
-                            bitmaps[k_bmp_hide_golden_lines],   // Checked state icon
-                            "Hide golden lines",                // Normal state tooltip
-                            "Show golden lines");               // Checked state tooltip
+                            "golden-lines-on.svg",      // Normal state icon
+                            "golden-lines-off.svg",     // Checked state icon
+                            "Hide golden lines",        // Normal state tooltip
+                            "Show golden lines");       // Checked state tooltip
     m_toolbar->add_check_tool(k_evt_show_frame,
-                            bitmaps[k_bmp_show_frame],   // Normal state icon
-                            bitmaps[k_bmp_hide_frame],   // Checked state icon
-                            "Hide frame",                // Normal state tooltip
-                            "Show frame");               // Checked state tooltip
-    m_toolbar->add_tool(k_evt_about, bitmaps[k_bmp_about], "About");
-    m_toolbar->add_tool(k_evt_quit, bitmaps[k_bmp_quit], "Quit");
+                            "frame-on.svg",     // Normal state icon
+                            "frame-off.svg",    // Checked state icon
+                            "Hide frame",       // Normal state tooltip
+                            "Show frame");      // Checked state tooltip
+    m_toolbar->add_tool(k_evt_about, "about.svg", "About");
+    m_toolbar->add_tool(k_evt_quit, "shutdown.svg", "Quit");
 
     //tools
     Bind(wxEVT_BUTTON, &MainFrame::on_quit, this, k_evt_quit);
@@ -187,40 +218,233 @@ void MainFrame::create_toolbar()
 //---------------------------------------------------------------------------------------
 void MainFrame::create_shaped_frame()
 {
-    //prepare the bitmap to draw on the screen.
-    draw_all_content();
+    TRACE_SCOPE("MainFrame::create_shaped_frame");
+    //rebuild the layers and collect the opaque rectangles in m_shape. Expensive
+    //states not in the cache are built in background
+    build_mask(use_render_thread());
+    if (m_fShapeIsInvalid)
+        apply_shape();
+}
 
-    //create the wxRegion that will define the frame shape. Set black as the
-    //colour for pixels that will define the mask for the transparent region
-    wxRegion rgn(m_bmpMask, *wxBLACK);
+//---------------------------------------------------------------------------------------
+bool MainFrame::use_render_thread() const
+{
+    //Until the result arrives, the previous layers and shape are displayed. This is
+    //fine while resizing, as the mouse must remain responsive, and for states so
+    //expensive that building them would stall the input. Otherwise, the state is
+    //built now, to not display a frame with the old content in the new geometry
+    //(see GeometryTransaction).
+
+    if (!m_pRenderThread || !m_fPainted)
+        return false;
+    if (m_fResizingMode)
+        return true;
+
+    wxSize size = GetClientSize();
+    long long cost = (long long)size.x * size.y * std::max(m_gridSize, 1);
+    return cost >= BACKGROUND_RENDER_COST;
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::apply_shape()
+{
+    m_fShapeIsInvalid = false;
+    m_diagnostics.count(k_diag_shapes);
+    DiagnosticsTimer timer(m_diagnostics, k_diag_set_shape);
 
-    //apply the region to the frame to set its shape.
-    if (!SetShape(rgn))
+    //while resizing, use a cheap approximate shape until the drag settles
+    m_fShapeIsApproximate = m_fResizingMode && !m_fDragSettled && m_fApproximateDragShape;
+    if (m_fShapeIsApproximate)
     {
-        wxLogError("[create_shaped_frame] Failed to set shape. The window will not be shaped.");
+        apply_approximate_shape();
+        return;
+    }
+
+    //build the shape directly from the opaque rectangles
+    if (!m_shape.apply_to(this))
+    {
+        wxLogError("[MainFrame::apply_shape] Failed to set shape. The window will not be shaped.");
+    }
+    else if (m_fCacheShape)
+    {
+        //states only seen while dragging are not cached, as they have no exact shape
+        m_shapeCache.add(get_shape_key(m_layout.get_options()), m_layers, m_shape);
+        m_fCacheShape = false;
     }
 }
 
 //---------------------------------------------------------------------------------------
-void MainFrame::on_paint(wxPaintEvent& WXUNUSED(event))
+void MainFrame::apply_approximate_shape()
+{
+    TRACE_SCOPE("MainFrame::apply_approximate_shape");
+    //The approximate shape only contains the toolbar strip, the frame, the border
+    //and the handlers. Grid and golden lines will not be visible while dragging.
+    add_layers_to_shape(m_partialShape, { k_layer_toolbar, k_layer_frame, k_layer_border });
+
+    if (!m_partialShape.apply_to(this))
+    {
+        wxLogError("[MainFrame::apply_approximate_shape] Failed to set shape.");
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::add_layers_to_shape(ShapeBuilder& shape, std::initializer_list<int> layers) const
+{
+    shape.clear(m_layersSize);
+    LayerBuilder::add_to_shape(m_layers, layers, shape);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::select_overlay_mode()
+{
+    // Two overlay modes are possible:
+    // - 'shaped': black pixels are transparent and each change requires to rebuild
+    //   the window shape. This works everywhere.
+    // - 'argb': the window has a transparent background and lines are painted with
+    //   per-pixel alpha. Only the input shape is set, and it does not contain the grid
+    //   and golden lines. Requires a compositing manager and the X11 Shape extension.
+    // Preference '/Render/OverlayMode' can be 'auto' (the default), 'shaped' or 'argb'.
+
+    wxConfigBase* pPrefs = wxGetApp().get_preferences();
+    wxString mode = pPrefs->Read("/Render/OverlayMode", "auto");
+
+    wxString reason;
+    bool fSupported = IsTransparentBackgroundSupported(&reason)
+                      && ShapeBuilder::has_input_shape_support();
+
+    m_fArgbMode = (mode != "shaped") && fSupported;
+    if (mode == "argb" && !fSupported)
+        wxLogWarning("[MainFrame::select_overlay_mode] ARGB overlay mode is not supported. %s", reason);
+
+    wxLogMessage("[MainFrame::select_overlay_mode] Overlay mode '%s'", (m_fArgbMode ? "argb" : "shaped"));
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::select_paint_backend()
+{
+    //The backend is set with option --paint-backend or with preference
+    //'/Render/PaintBackend' (see PaintBackend). The ARGB overlay mode always uses
+    //"gc", as the other backends do not support the lines opacity.
+
+    wxString name = wxGetApp().get_paint_backend();
+    if (m_fArgbMode && name != "gc")
+    {
+        wxLogMessage("[MainFrame::select_paint_backend] Paint backend '%s' is not "
+                     "supported in ARGB overlay mode", name);
+        name = "gc";
+    }
+
+    m_pPaintBackend.reset(PaintBackend::create(name, m_resources));
+    if (!m_pPaintBackend)
+    {
+        wxLogWarning("[MainFrame::select_paint_backend] Unknown paint backend '%s'", name);
+        m_pPaintBackend.reset(new GcPaintBackend(m_resources));
+    }
+
+    wxLogMessage("[MainFrame::select_paint_backend] Paint backend '%s'",
+                 m_pPaintBackend->get_name());
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::paint_argb_overlay()
 {
+    TRACE_SCOPE("MainFrame::paint_argb_overlay");
+    //In ARGB mode there is no visible window shape. The layers are painted
+    //with per-pixel alpha on a transparent background, and only the input shape
+    //has to be updated when the layers change.
+
     wxSize size = GetClientSize();
-    if (m_fBitmapIsInvalid || m_bmpMask.GetWidth() != size.GetWidth()
-        || m_bmpMask.GetHeight() != size.GetHeight() )
+    if (m_fMaskIsInvalid || size != m_layersSize || m_toolbarHeight != m_layersToolbarHeight)
     {
-        create_shaped_frame();
+        {
+            DiagnosticsTimer timer(m_diagnostics, k_diag_draw);
+            update_layers(size);
+            m_fMaskIsInvalid = false;
+        }
+
+        m_diagnostics.count(k_diag_shapes);
+        DiagnosticsTimer timer(m_diagnostics, k_diag_set_shape);
+
+        //the grid and golden lines do not receive mouse events
+        add_layers_to_shape(m_partialShape, { k_layer_toolbar, k_layer_frame, k_layer_border });
+        if (!m_partialShape.apply_input_to(this))
+        {
+            //fall back to a visible shape, with all the content
+            add_layers_to_shape(m_shape, { k_layer_toolbar, k_layer_frame, k_layer_grid,
+                                           k_layer_golden_lines, k_layer_border });
+            m_shape.apply_to(this);
+        }
     }
 
-    if (m_bmpMask.IsOk())
+    wxPaintDC dc(this);
+    std::unique_ptr<wxGraphicsContext> gc(wxGraphicsContext::Create(dc));
+    if (!gc)
+        return;
+
+    //clear only the damaged area to fully transparent
+    const wxRegion& damaged = GetUpdateRegion();
+    gc->SetCompositionMode(wxCOMPOSITION_SOURCE);
+    gc->SetPen(*wxTRANSPARENT_PEN);
+    gc->SetBrush(m_resources.get_brush(wxTransparentColour));
+    for (wxRegionIterator it(damaged); it; ++it)
     {
+        gc->DrawRectangle(it.GetX(), it.GetY(), it.GetW(), it.GetH());
+    }
+
+    //the backend paints on the DC: the context is released with the default mode
+    gc->SetCompositionMode(wxCOMPOSITION_OVER);
+    gc.reset();
+
+    //paint the layers. Grid and golden lines use the lines opacity
+    m_pPaintBackend->paint(dc, m_layers, damaged, m_linesOpacity);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::on_paint(wxPaintEvent& WXUNUSED(event))
+{
+    TRACE_SCOPE("MainFrame::on_paint");
+    m_diagnostics.count(k_diag_paints);
+
+    if (m_fArgbMode)
+        paint_argb_overlay();
+    else
+    {
+        wxSize size = GetClientSize();
+        if (m_fMaskIsInvalid || size != m_layersSize
+            || m_toolbarHeight != m_layersToolbarHeight)
+        {
+            create_shaped_frame();
+        }
+        else if (m_fShapeIsInvalid)
+            apply_shape();
+
+        //Paints the opaque rectangles of all layers, in drawing order. The rest of
+        //the window is not painted, as it is outside the window shape. While
+        //dragging with the approximate shape, grid and golden lines are clipped by
+        //the shape.
         wxPaintDC dc(this);
-        dc.DrawBitmap(m_bmpMask, 0, 0, false); // `false` to ignore transparency
+        m_pPaintBackend->paint(dc, m_layers, GetUpdateRegion(), 255);
+    }
+
+    if (!m_fPainted)
+    {
+        m_fPainted = true;
+        wxGetApp().on_first_paint();
+    }
+
+    //the new geometry is now visible, unless its content is still being built
+    if (m_fPresentPending && !m_fRenderPending)
+    {
+        m_fPresentPending = false;
+        m_dragLatency.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - m_presentTime).count());
     }
 }
 
 //---------------------------------------------------------------------------------------
 void MainFrame::on_quit(wxCommandEvent& WXUNUSED(event))
 {
+    TRACE_SCOPE("MainFrame::on_quit");
     wxConfigBase* pPrefs =  wxGetApp().get_preferences();
     pPrefs->Write("/Size/Ratio", m_aspectRatio);
     pPrefs->Write("/Size/Locked", m_fAspectRatioLocked);
@@ -230,230 +454,392 @@ void MainFrame::on_quit(wxCommandEvent& WXUNUSED(event))
     pPrefs->Write("/Grid/GoldenLinesColor", m_goldenLinesColour.GetAsString(wxC2S_HTML_SYNTAX));
     pPrefs->Write("/Grid/ToolbarColor", m_toolbarColour.GetAsString(wxC2S_HTML_SYNTAX));
     pPrefs->Write("/Grid/FrameColor", m_frameColour.GetAsString(wxC2S_HTML_SYNTAX));
+    wxGetApp().save_preferences();
 
     Close(true);
 }
 
 //---------------------------------------------------------------------------------------
-void MainFrame::draw_all_content()
+void MainFrame::build_mask(bool fInBackground)
 {
-    // Create a new bitmap of the specified window size and draw all content on it.
+    //The mask is not a bitmap but the list of opaque rectangles of all the layers,
+    //in m_shape. Everything else is transparent.
+    //When fInBackground is true, a state that is not in the cache is built by the
+    //render thread, and the mask remains invalid until the result arrives.
     //AWARE: Black regions will be transparent so do not use black colour in
-    //       the image. BLACK COLOUR WILL BE TRANSPARENT!
+    //       the layers. BLACK COLOUR WILL BE TRANSPARENT!
 
+    TRACE_SCOPE("MainFrame::build_mask");
+    DiagnosticsTimer timer(m_diagnostics, k_diag_draw);
     wxSize size = GetClientSize();
+    check_layers_size(size);
+    GridLayoutOptions options = get_layout_options(size);
 
-    m_bmpMask = wxBitmap(size);
-    if (!m_bmpMask.IsOk())
+    bool fRebuild = has_dirty_layers();
+    if (fRebuild)
     {
-        wxLogError("[MainFrame::draw_all_content] Failed to create mask bitmap.");
-        return;
+        m_nextSpeculation = 0;      //the states one toggle away have changed
+
+        //this state is already being built in background
+        if (fInBackground && m_fRenderPending && options == m_renderOptions)
+            return;
     }
 
-    // Create a memory device context and select the bitmap into it.
-    wxMemoryDC dc;
-    dc.SelectObject(m_bmpMask);
+    //a state seen before: layers and shape are restored from the cache. Not while
+    //resizing: each drag step is a new size, and would only count as a miss
+    if (fRebuild && !m_fResizingMode
+        && m_shapeCache.restore(get_shape_key(options), m_layers, &m_shape))
+    {
+        m_diagnostics.count(k_diag_cache_restores);
+        m_layout.update(options);
+        m_fRenderPending = false;
+        m_fCacheShape = false;
+        m_fMaskIsInvalid = false;
+        m_fShapeIsInvalid = true;
+        return;
+    }
 
-    // Set the background color to black or to frame colour.
-    dc.SetBackground(m_fDrawFrame ? m_frameColour : *wxBLACK);
-    dc.Clear();
+    if (fRebuild && fInBackground && m_pRenderThread)
+    {
+        m_diagnostics.count(k_diag_background);
+        submit_render(options);
+        return;
+    }
 
-    // Draw the coloured rectangle at the top, for the toolbar.
-    dc.SetBrush(wxBrush(m_toolbarColour));
-    dc.SetPen(*wxTRANSPARENT_PEN);
-    dc.DrawRectangle(0, 0, size.GetWidth(), m_toolbarHeight);
+    //rebuild the layers whose content has changed
+    m_fRenderPending = false;
+    m_layout.update(options);
+    LayerBuilder::build_dirty_layers(m_layout, get_layer_colours(), m_layers);
 
-    // Define the bottom rectangle where the grid will be drawn.
-    m_clientRect = wxRect(0, m_toolbarHeight, size.GetWidth(), size.GetHeight() - m_toolbarHeight);
+    //the vectors keep their capacity: no memory is allocated once they are big enough
+    add_layers_to_shape(m_shape, { k_layer_toolbar, k_layer_frame, k_layer_grid,
+                                   k_layer_golden_lines, k_layer_border });
+    m_fMaskIsInvalid = false;
+    m_fShapeIsInvalid = true;
 
-    // Define the grid area and draw the frame
-    m_gridRect = m_clientRect;
-    if (m_fDrawFrame)
+    //the new state is cached when its exact shape is applied
+    if (fRebuild)
     {
-        m_gridRect.Deflate(m_frameThickness);
-
-        //make the grid area transparent
-//        dc.SetBrush(wxBrush(m_frameColour));
-//        dc.SetPen(*wxTRANSPARENT_PEN);
-//        dc.DrawRectangle(m_clientRect.GetLeft(), m_clientRect.GetTop(), m_clientRect.GetWidth(), m_clientRect.GetHeight());
-        dc.SetBrush(wxBrush(*wxBLACK));
-        dc.SetPen(*wxTRANSPARENT_PEN);
-        dc.DrawRectangle(m_gridRect.GetLeft(), m_gridRect.GetTop(), m_gridRect.GetWidth(), m_gridRect.GetHeight());
+        m_diagnostics.count(k_diag_rebuilds);
+        m_fCacheShape = true;
     }
+}
 
-//    wxLogMessage("[MainFrame::draw_all_content] client=(%d,%d,%d,%d), grid=(%d,%d,%d,%d)",
-//        m_clientRect.x, m_clientRect.y, m_clientRect.width, m_clientRect.height,
-//        m_gridRect.x, m_gridRect.y, m_gridRect.width, m_gridRect.height );
+//---------------------------------------------------------------------------------------
+void MainFrame::submit_render(const GridLayoutOptions& options)
+{
+    //Meanwhile, the previous layers are painted and the previous shape is kept
+    m_renderOptions = options;
+    m_fRenderPending = true;
+
+    RenderJob job;
+    job.generation = ++m_renderGeneration;
+    job.options = options;
+    job.colours = get_layer_colours();
+    m_pRenderThread->submit(job);
+}
 
-    //Draw all content
-    draw_grid_lines(dc);
-    draw_golden_lines(dc);
-    draw_border(dc);
-    draw_resize_handlers(dc);
+//---------------------------------------------------------------------------------------
+void MainFrame::on_render_done(wxThreadEvent& WXUNUSED(event))
+{
+    TRACE_SCOPE("MainFrame::on_render_done");
+    std::unique_ptr<RenderResult> pResult = m_pRenderThread->take_result();
 
-    // Deselect the bitmap from the device context.
-    dc.SelectObject(wxNullBitmap);
-    m_fBitmapIsInvalid = false;
+    //a result is outdated when a newer state has been requested or built
+    if (!pResult || !m_fRenderPending || pResult->job.generation != m_renderGeneration)
+        return;
 
-//    wxLogMessage("[MainFrame::draw_all_content] Bitmap recreated.");
+    //swap in the new content. The previous one is deleted with the result
+    m_fRenderPending = false;
+    std::swap(m_layout, pResult->layout);
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        m_layers[i].rects.swap(pResult->layers[i].rects);
+        m_layers[i].fDirty = false;
+    }
+    std::swap(m_shape, pResult->shape);
+    m_fMaskIsInvalid = false;
+    m_fCacheShape = true;
 
+    //the shape and the content change together, in next paint
+    apply_shape();
+    Refresh(false);
+}
 
-//    // Save the bitmap as mask2.png.
-//    if (!m_bmpMask.SaveFile("mask.png", wxBITMAP_TYPE_PNG))
-//    {
-//        wxLogError("[MainFrame::draw_all_content] Failed to export 'mask.png'.");
-//    }
+//---------------------------------------------------------------------------------------
+ShapeKey MainFrame::get_shape_key(const GridLayoutOptions& options) const
+{
+    ShapeKey key;
+    key.width = options.width;
+    key.height = options.height;
+    key.toolbarHeight = options.toolbarHeight;
+    key.gridSize = options.gridSize;
+    key.lineThickness = options.lineThickness;
+    key.frameThickness = options.frameThickness;
+    key.handlerSide = options.handlerSide;
+    LayerColours colours = get_layer_colours();
+    key.colours[0] = colours.toolbar;
+    key.colours[1] = colours.frame;
+    key.colours[2] = colours.gridLines;
+    key.colours[3] = colours.goldenLines;
+    key.flags = (options.fFrame ? 1 : 0) | (options.fGrid ? 2 : 0)
+                | (options.fGoldenLines ? 4 : 0) | (options.fHandlers ? 8 : 0);
+    return key;
 }
 
 //---------------------------------------------------------------------------------------
-void MainFrame::get_grid_options()
+void MainFrame::on_idle(wxIdleEvent& event)
 {
-    // Get current values for the grid options from the configuration
+    //When the user is not interacting, the states one toolbar toggle away from the
+    //current one are built in advance and added to the shape cache, one state per
+    //idle event. Pending input stops the work; it continues in next idle time.
 
-    wxConfigBase* pPrefs = wxGetApp().get_preferences();
-    m_gridSize = pPrefs->Read("/Grid/Segments", 3);
-    m_gridLineThickness = pPrefs->Read("/Grid/LineThickness", 1);
+    if (m_nextSpeculation >= k_spec_max || m_fArgbMode || !m_shapeCache.is_enabled()
+        || m_fMoveMode || m_fResizingMode || m_fMaskIsInvalid || wxTheApp->Pending())
+    {
+        return;
+    }
 
-    wxString sGridColour("#FFFFFF");
-    pPrefs->Read("/Grid/LineColor", &sGridColour, "#FFFFFF");
-    m_gridLinesColour.Set(sGridColour);
+    prebuild_state(m_nextSpeculation++);
+    if (m_nextSpeculation < k_spec_max)
+        event.RequestMore();
+}
 
-    wxString sGoldenColour("#FFD700");
-    pPrefs->Read("/Grid/GoldenLinesColor", &sGoldenColour, "#FFD700");
-    m_goldenLinesColour.Set(sGoldenColour);
+//---------------------------------------------------------------------------------------
+void MainFrame::prebuild_state(int state)
+{
+    TRACE_SCOPE("MainFrame::prebuild_state");
+    GridLayoutOptions options = m_layout.get_options();
+    switch (state)
+    {
+        case k_spec_grid:
+            options.fGrid = !options.fGrid;
+            break;
+        case k_spec_golden_lines:
+            options.fGoldenLines = !options.fGoldenLines;
+            break;
+        case k_spec_frame:
+        {
+            //the window grows or shrinks around the grid. See GeometryTransaction
+            int delta = 2 * (options.fFrame ? -m_frameThickness : m_frameThickness);
+            options.fFrame = !options.fFrame;
+            options.width += delta;
+            options.height += delta;
+            break;
+        }
+    }
+    if (options.width <= 0 || options.height <= options.toolbarHeight)
+        return;
 
-    wxString sToolbarColour("#49B04A");
-    pPrefs->Read("/Grid/ToolbarColor", &sToolbarColour, "#49B04A");
-    m_toolbarColour.Set(sToolbarColour);
+    ShapeKey key = get_shape_key(options);
+    if (m_shapeCache.contains(key))
+        return;
 
-    wxString sFrameColour("#2F2F2F");
-    pPrefs->Read("/Grid/FrameColor", &sFrameColour, "#2F2F2F");
-    m_frameColour.Set(sFrameColour);
+    //build the layers and the shape aside, without changing the current ones
+    m_specLayout.update(options);
+    for (RenderLayer& layer : m_specLayers)
+    {
+        layer.fDirty = true;
+    }
+    LayerBuilder::build_dirty_layers(m_specLayout, get_layer_colours(), m_specLayers);
 
-    change_black_colours();
+    m_specShape.clear(wxSize(options.width, options.height));
+    LayerBuilder::add_to_shape(m_specLayers, { k_layer_toolbar, k_layer_frame, k_layer_grid,
+                                               k_layer_golden_lines, k_layer_border },
+                               m_specShape);
+
+    //the region is only used when the shape can not be set with XShape
+    if (!ShapeBuilder::has_input_shape_support())
+        m_specShape.get_region();
+
+    m_shapeCache.add(key, m_specLayers, m_specShape);
 }
 
 //---------------------------------------------------------------------------------------
-void MainFrame::change_black_colours()
+void MainFrame::update_layers(const wxSize& size)
 {
-    //Don't allow black colour as it will transformed into transparent
-
-    if (m_goldenLinesColour == *wxBLACK)
-        m_goldenLinesColour = wxColour("#000005");
+    TRACE_SCOPE("MainFrame::update_layers");
+    update_layout(size);
+    LayerBuilder::build_dirty_layers(m_layout, get_layer_colours(), m_layers);
+}
 
-    if (m_gridLinesColour == *wxBLACK)
-        m_gridLinesColour = wxColour("#000005");
+//---------------------------------------------------------------------------------------
+void MainFrame::update_layout(const wxSize& size)
+{
+    check_layers_size(size);
 
-    if (m_toolbarColour == *wxBLACK)
-        m_toolbarColour = wxColour("#000005");
+    //recompute the geometry of all primitives, if any option has changed
+    m_layout.update(get_layout_options(size));
+}
 
-    if (m_frameColour == *wxBLACK)
-        m_frameColour = wxColour("#000005");
+//---------------------------------------------------------------------------------------
+void MainFrame::check_layers_size(const wxSize& size)
+{
+    //A change in window size or toolbar height changes the geometry of all layers
+    if (size != m_layersSize || m_toolbarHeight != m_layersToolbarHeight)
+    {
+        invalidate_all_layers();
+        m_layersSize = size;
+        m_layersToolbarHeight = m_toolbarHeight;
+    }
 }
 
 //---------------------------------------------------------------------------------------
-void MainFrame::draw_border(wxDC& dc)
+GridLayoutOptions MainFrame::get_layout_options(const wxSize& size) const
 {
-    // Draw a white border around the grid bitmap.
-    // We use a transparent brush so it doesn't fill the rectangle.
+    GridLayoutOptions options;
+    options.width = size.GetWidth();
+    options.height = size.GetHeight();
+    options.toolbarHeight = m_toolbarHeight;
+    options.fFrame = m_fDrawFrame;
+    options.frameThickness = m_frameThickness;
+    options.fGrid = m_fDrawGrid;
+    options.gridSize = m_gridSize;
+    options.lineThickness = m_gridLineThickness;
+    options.fGoldenLines = m_fDrawGoldenLines;
+    options.fHandlers = m_fDrawHandlers;
+    options.handlerSide = m_handlerSide;
+    return options;
+}
 
-    wxPen whitePen(*wxWHITE, m_gridLineThickness);
-    dc.SetPen(whitePen);
-    dc.SetBrush(*wxTRANSPARENT_BRUSH);
-    dc.DrawRectangle(m_gridRect);
+//---------------------------------------------------------------------------------------
+LayerColours MainFrame::get_layer_colours() const
+{
+    LayerColours colours;
+    colours.toolbar = m_toolbarColour.GetRGBA();
+    colours.frame = m_frameColour.GetRGBA();
+    colours.gridLines = m_gridLinesColour.GetRGBA();
+    colours.goldenLines = m_goldenLinesColour.GetRGBA();
+    return colours;
 }
 
 //---------------------------------------------------------------------------------------
-void MainFrame::draw_grid_lines(wxDC& dc)
+bool MainFrame::has_dirty_layers() const
 {
-    if (m_fDrawGrid && m_gridSize > 1)
+    for (int i = 0; i < k_layer_max; ++i)
     {
-        int width = m_gridRect.GetWidth();
-        int height = m_gridRect.GetHeight();
-        int left = m_gridRect.GetLeft();
-        int top = m_gridRect.GetTop();
+        if (m_layers[i].fDirty)
+            return true;
+    }
+    return false;
+}
 
-        wxPen gridPen(m_gridLinesColour, m_gridLineThickness, wxPENSTYLE_SOLID);
-        dc.SetPen(gridPen);
+//---------------------------------------------------------------------------------------
+void MainFrame::invalidate_layer(int layer)
+{
+    m_layers[layer].fDirty = true;
+    m_fMaskIsInvalid = true;
+}
 
-        // Draw vertical lines
-        for (int i = 1; i < m_gridSize; ++i)
-        {
-            int x = ((width * i) / m_gridSize) + left;
-            dc.DrawLine(x, top, x, height + top);
-       }
-        // Draw horizontal lines
-        for (int i = 1; i < m_gridSize; ++i)
-        {
-            int y = ((height * i) / m_gridSize) + top;
-            dc.DrawLine(left, y, width + left, y);
-        }
+//---------------------------------------------------------------------------------------
+void MainFrame::invalidate_all_layers()
+{
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        m_layers[i].fDirty = true;
     }
+    m_fMaskIsInvalid = true;
 }
 
 //---------------------------------------------------------------------------------------
-void MainFrame::draw_golden_lines(wxDC& dc)
+void MainFrame::refresh_layers(const std::vector<int>& layers)
 {
-    if (m_fDrawGoldenLines)
-    {
-        int width = m_gridRect.GetWidth();
-        int height = m_gridRect.GetHeight();
-        int left = m_gridRect.GetLeft();
-        int top = m_gridRect.GetTop();
+    //Invalidates the layers and repaints only the window area they cover, before
+    //and after rebuilding them. The rest of the window does not change.
 
-        wxPen goldenPen(m_goldenLinesColour, m_gridLineThickness, wxPENSTYLE_SOLID);
-        dc.SetPen(goldenPen);
+    for (int layer : layers)
+    {
+        refresh_layer_area(layer);
+        invalidate_layer(layer);
+    }
 
-        //calculate golden ratio segments for width and height
-        int golden_width_b = static_cast<int>(std::round(width / GOLDEN_RATIO));
-        int golden_height_b = static_cast<int>(std::round(height / GOLDEN_RATIO));
+    //if the window geometry has changed all layers will be rebuilt
+    wxSize size = GetClientSize();
+    if (size != m_layersSize || m_toolbarHeight != m_layersToolbarHeight)
+    {
+        Refresh();
+        return;
+    }
 
-        //vertical golden lines
-        dc.DrawLine(golden_width_b + left, top, golden_width_b + left, height + top);
-        dc.DrawLine(left + width - golden_width_b, top, left + width - golden_width_b, height + top);
+    //in shaped mode the layers can be restored from the shape cache. The shape is
+    //applied in next paint
+    if (m_fArgbMode)
+        update_layers(size);
+    else
+        build_mask();
 
-        //horizontal golden lines
-        dc.DrawLine(left, golden_height_b + top, width + left, golden_height_b + top);
-        dc.DrawLine(left, top + height - golden_height_b, width + left, top + height - golden_height_b);
+    for (int layer : layers)
+    {
+        refresh_layer_area(layer);
     }
 }
 
 //---------------------------------------------------------------------------------------
-void MainFrame::draw_resize_handlers(wxDC& dc)
+void MainFrame::refresh_layer_area(int layer)
 {
-    if (m_fDrawHandlers)
+    for (const FilledRect& filled : m_layers[layer].rects)
     {
-        wxPen borderPen(wxColour(0,0,5), 2);    //nearly black, black cannot be used
-        dc.SetBrush(*wxWHITE);
-        dc.SetPen(borderPen);
+        RefreshRect(filled.rect, false);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::get_grid_options()
+{
+    // Get current values for the grid options from the configuration
+
+    wxConfigBase* pPrefs = wxGetApp().get_preferences();
+    m_gridSize = pPrefs->Read("/Grid/Segments", 3);
+    m_gridLineThickness = pPrefs->Read("/Grid/LineThickness", 1);
 
-        int halfHandle = (m_handlerSide - m_gridLineThickness) / 2;
+    wxString sGridColour("#FFFFFF");
+    pPrefs->Read("/Grid/LineColor", &sGridColour, "#FFFFFF");
+    m_gridLinesColour.Set(sGridColour);
 
-        //right handle
-        m_rightHandle = wxRect(m_gridRect.GetRight() - m_handlerSide,
-                               m_gridRect.GetTop() + m_gridRect.GetHeight() / 2 - halfHandle,
-                               m_handlerSide, m_handlerSide);
-        dc.DrawRectangle(m_rightHandle);
+    wxString sGoldenColour("#FFD700");
+    pPrefs->Read("/Grid/GoldenLinesColor", &sGoldenColour, "#FFD700");
+    m_goldenLinesColour.Set(sGoldenColour);
+
+    wxString sToolbarColour("#49B04A");
+    pPrefs->Read("/Grid/ToolbarColor", &sToolbarColour, "#49B04A");
+    m_toolbarColour.Set(sToolbarColour);
 
+    wxString sFrameColour("#2F2F2F");
+    pPrefs->Read("/Grid/FrameColor", &sFrameColour, "#2F2F2F");
+    m_frameColour.Set(sFrameColour);
 
-        //left handle
-        m_leftHandle  = wxRect(m_gridRect.GetLeft(),
-                               m_gridRect.GetTop() + m_gridRect.GetHeight() / 2 - halfHandle,
-                               m_handlerSide, m_handlerSide);
-        dc.DrawRectangle(m_leftHandle);
+    change_black_colours();
 
-        //top handle
-        m_topHandle = wxRect(m_gridRect.GetLeft() + m_gridRect.GetWidth() / 2 - halfHandle,
-                             m_gridRect.GetTop(),
-                             m_handlerSide, m_handlerSide);
-        dc.DrawRectangle(m_topHandle);
+    //lines opacity (0 to 255) is only used in ARGB overlay mode
+    long opacity = pPrefs->Read("/Grid/LinesOpacity", 255L);
+    m_linesOpacity = static_cast<unsigned char>(std::min(std::max(opacity, 0L), 255L));
 
-        //bottom handle
-        m_bottomHandle = wxRect(m_gridRect.GetLeft() + m_gridRect.GetWidth() / 2 - halfHandle,
-                                m_gridRect.GetBottom() - m_handlerSide,
-                                m_handlerSide, m_handlerSide);
-        dc.DrawRectangle(m_bottomHandle);
-    }
+    //rendering options
+    pPrefs->Read("/Render/ApproximateDragShape", &m_fApproximateDragShape, true);
+    long cacheKB = pPrefs->Read("/Render/ShapeCacheKB", 1024L);
+    m_shapeCache.set_budget(static_cast<size_t>(std::max(cacheKB, 0L)) * 1024);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::change_black_colours()
+{
+    //Don't allow black colour as it will transformed into transparent. Black is
+    //valid in ARGB overlay mode, as transparency is not defined by colour
+
+    if (m_fArgbMode)
+        return;
+
+    if (m_goldenLinesColour == *wxBLACK)
+        m_goldenLinesColour = wxColour("#000005");
+
+    if (m_gridLinesColour == *wxBLACK)
+        m_gridLinesColour = wxColour("#000005");
+
+    if (m_toolbarColour == *wxBLACK)
+        m_toolbarColour = wxColour("#000005");
+
+    if (m_frameColour == *wxBLACK)
+        m_frameColour = wxColour("#000005");
 }
 
 //---------------------------------------------------------------------------------------
@@ -468,7 +854,8 @@ void MainFrame::change_and_lock_aspect_ratio(const double newAspectRatio)
     m_toolbar->set_tool_checked(k_evt_lock_aspect_ratio, true);
 
     // Get the current client size
-    wxSize clientSize = GetClientSize();
+    GeometryTransaction transaction(this);
+    wxSize clientSize = transaction.get_client_size();
 
     // Calculate new dimensions based on the current size and the new aspect ratio
     int newWidthFromHeight = static_cast<int>(clientSize.GetHeight() * m_aspectRatio);
@@ -477,11 +864,13 @@ void MainFrame::change_and_lock_aspect_ratio(const double newAspectRatio)
     // Choose the new size that results in a smaller or equal window size
     if (newWidthFromHeight <= clientSize.GetWidth())
     {
-        SetClientSize(newWidthFromHeight, clientSize.GetHeight() + m_toolbarHeight);
+        transaction.set_client_size(wxSize(newWidthFromHeight,
+                                           clientSize.GetHeight() + m_toolbarHeight));
     }
     else
     {
-        SetClientSize(clientSize.GetWidth(), newHeightFromWidth + m_toolbarHeight);
+        transaction.set_client_size(wxSize(clientSize.GetWidth(),
+                                           newHeightFromWidth + m_toolbarHeight));
     }
 }
 
@@ -499,29 +888,22 @@ void MainFrame::lock_aspect_ratio(const bool value)
 //---------------------------------------------------------------------------------------
 ResizeDirection MainFrame::determine_resize_direction(const wxPoint& mousePos)
 {
-    if (m_rightHandle.Contains(mousePos))
+    switch (m_layout.hit_test(mousePos.x, mousePos.y))
     {
-        return ResizeDirection::RIGHT;
+        case k_zone_handle_right:   return ResizeDirection::RIGHT;
+        case k_zone_handle_left:    return ResizeDirection::LEFT;
+        case k_zone_handle_top:     return ResizeDirection::TOP;
+        case k_zone_handle_bottom:  return ResizeDirection::BOTTOM;
+        default:
+            return ResizeDirection::NONE;
     }
-    else if (m_leftHandle.Contains(mousePos))
-    {
-        return ResizeDirection::LEFT;
-    }
-    else if (m_topHandle.Contains(mousePos))
-    {
-        return ResizeDirection::TOP;
-    }
-    else if (m_bottomHandle.Contains(mousePos))
-    {
-        return ResizeDirection::BOTTOM;
-    }
-
-    return ResizeDirection::NONE;
 }
 
 //---------------------------------------------------------------------------------------
 void MainFrame::on_mouse_left_down(wxMouseEvent& event)
 {
+    TRACE_SCOPE("MainFrame::on_mouse_left_down");
+    record_mouse(k_input_left_down, event);
     wxPoint pos = event.GetPosition(); // Mouse position relative to frame client area
     m_moveStartPos = ClientToScreen(pos);
     m_frameStartPos = GetPosition();
@@ -533,7 +915,8 @@ void MainFrame::on_mouse_left_down(wxMouseEvent& event)
         m_moveStartPos = ClientToScreen(pos);
         m_frameStartPos = GetPosition();
 //        wxLogMessage("Move handle clicked. Starting moving the window");
-        SetCursor(wxCursor(wxCURSOR_CROSS));
+        set_cursor(wxCURSOR_CROSS);
+        start_drag();
     }
     else
     {
@@ -541,6 +924,7 @@ void MainFrame::on_mouse_left_down(wxMouseEvent& event)
         if (m_resizeDirection != ResizeDirection::NONE)
         {
             resize_window_left_mouse_down(event);
+            start_drag();
         }
     }
     event.Skip();
@@ -549,20 +933,20 @@ void MainFrame::on_mouse_left_down(wxMouseEvent& event)
 //---------------------------------------------------------------------------------------
 void MainFrame::on_mouse_motion(wxMouseEvent& event)
 {
-    //mose pos is relative to m_clientRect origin. so negative vules are out of it,
-    //no top, left, and positive values grater than m_clientRect size are also outside.
+    TRACE_SCOPE("MainFrame::on_mouse_motion");
+    record_mouse(k_input_motion, event);
+    //mose pos is relative to the window client area origin. so negative vules are
+    //out of it, and positive values grater than the window size are also outside.
+    m_diagnostics.count(k_diag_motion);
     wxPoint mousePos = event.GetPosition();
-//    wxLogMessage("[MainFrame::on_mouse_motion] Mouse=(%d,%d), right handle=(%d,%d, %d, %d)"
-//                 ", Client=(%d, %d, %d, %d), grid==(%d, %d, %d, %d)",
-//                 mousePos.x, mousePos.y,
-//                 m_rightHandle.x, m_rightHandle.y, m_rightHandle.width, m_rightHandle.height,
-//                 m_clientRect.x, m_clientRect.y, m_clientRect.width, m_clientRect.height,
-//                 m_gridRect.x, m_gridRect.y, m_gridRect.width, m_gridRect.height);
+//    wxLogMessage("[MainFrame::on_mouse_motion] Mouse=(%d,%d), zone=%d",
+//                 mousePos.x, mousePos.y, m_layout.hit_test(mousePos.x, mousePos.y));
 
     //handle capture/release mouse and mouse icon
     if (!m_fResizingMode && !m_fMoveMode)
     {
-        bool fMouseInside = m_gridRect.Contains(mousePos);
+        EGridZone zone = m_layout.hit_test(mousePos.x, mousePos.y);
+        bool fMouseInside = (zone != k_zone_outside);
         if (fMouseInside && !m_fMouseCaptured)
         {
             CaptureMouse();
@@ -571,17 +955,17 @@ void MainFrame::on_mouse_motion(wxMouseEvent& event)
         }
         else if (fMouseInside && m_fMouseCaptured)
         {
-            if (m_rightHandle.Contains(mousePos) || m_leftHandle.Contains(mousePos))
+            if (zone == k_zone_handle_right || zone == k_zone_handle_left)
             {
-                SetCursor(wxCursor(wxCURSOR_SIZEWE));
+                set_cursor(wxCURSOR_SIZEWE);
             }
-            else if (m_topHandle.Contains(mousePos) || m_bottomHandle.Contains(mousePos))
+            else if (zone == k_zone_handle_top || zone == k_zone_handle_bottom)
             {
-                SetCursor(wxCursor(wxCURSOR_SIZENS));
+                set_cursor(wxCURSOR_SIZENS);
             }
             else
             {
-                SetCursor(wxCursor(wxCURSOR_ARROW));
+                set_cursor(wxCURSOR_ARROW);
             }
         }
         else if (!fMouseInside && HasCapture())
@@ -589,7 +973,7 @@ void MainFrame::on_mouse_motion(wxMouseEvent& event)
             ReleaseMouse();
             m_fMouseCaptured = false;
 //            wxLogMessage("[MainFrame::on_mouse_motion] Mouse Released");
-            SetCursor(wxCursor(wxCURSOR_ARROW));
+            set_cursor(wxCURSOR_ARROW);
         }
         event.Skip();
         return;
@@ -614,20 +998,157 @@ void MainFrame::on_mouse_motion(wxMouseEvent& event)
         int deltaX = currentScreenPos.x - m_moveStartPos.x;
         int deltaY = currentScreenPos.y - m_moveStartPos.y;
 
-        SetPosition(m_frameStartPos + wxPoint(deltaX, deltaY));
+        queue_geometry(wxRect(m_frameStartPos + wxPoint(deltaX, deltaY), GetSize()));
     }
 
     event.Skip();
 }
 
+//---------------------------------------------------------------------------------------
+void MainFrame::on_mouse_left_dclick(wxMouseEvent& event)
+{
+    TRACE_SCOPE("MainFrame::on_mouse_left_dclick");
+    record_mouse(k_input_left_dclick, event);
+    //hidden gestures: Ctrl + double click on the move handle toggles the HUD, and
+    //Shift + double click writes the drag latency statistics to the log
+    if (m_toolbar->get_move_handle().Contains(event.GetPosition()))
+    {
+        if (event.ControlDown())
+        {
+            toggle_hud();
+            return;
+        }
+        if (event.ShiftDown())
+        {
+            wxLogMessage("[MainFrame::on_mouse_left_dclick] %s",
+                         m_dragLatency.get_report("drag"));
+            return;
+        }
+    }
+    event.Skip();
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::record_mouse(EInputKind kind, const wxMouseEvent& event)
+{
+    //Positions are saved in screen coordinates, as the window moves while dragging.
+    //Events forwarded by the toolbar have the same origin, as it is placed at (0,0)
+    InputRecorder& recorder = wxGetApp().get_input_recorder();
+    if (!recorder.is_recording())
+        return;
+
+    int flags = (event.LeftIsDown() ? k_input_left_is_down : 0)
+                | (event.ControlDown() ? k_input_control_down : 0);
+    recorder.add(kind, ClientToScreen(event.GetPosition()), flags);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::record_tool(const wxCommandEvent& event)
+{
+    //Only the check tools are recorded. Other tools open dialogs or quit
+    InputRecorder& recorder = wxGetApp().get_input_recorder();
+    if (recorder.is_recording())
+        recorder.add(k_input_tool, wxPoint(event.GetId(), event.GetInt()), 0);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::replay_input(const InputEvent& input)
+{
+    if (input.kind == k_input_tool)
+    {
+        m_toolbar->set_tool_checked(input.x, input.y != 0);
+        wxCommandEvent event(wxEVT_BUTTON, input.x);
+        event.SetInt(input.y);
+        event.SetEventObject(m_toolbar);
+        ProcessWindowEvent(event);
+        return;
+    }
+
+    wxEventType type;
+    switch (input.kind)
+    {
+        case k_input_left_down:     type = wxEVT_LEFT_DOWN;     break;
+        case k_input_motion:        type = wxEVT_MOTION;        break;
+        case k_input_left_up:       type = wxEVT_LEFT_UP;       break;
+        case k_input_left_dclick:   type = wxEVT_LEFT_DCLICK;   break;
+        default:
+            return;
+    }
+
+    wxMouseEvent event(type);
+    event.SetPosition(ScreenToClient(wxPoint(input.x, input.y)));
+    event.SetLeftDown((input.flags & k_input_left_is_down) != 0);
+    event.SetControlDown((input.flags & k_input_control_down) != 0);
+    event.SetEventObject(this);
+    ProcessWindowEvent(event);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::toggle_hud()
+{
+    // The diagnostics HUD shows, in the toolbar strip, the paint, shape and mouse
+    // motion rates and the durations of drawing and shaping. It is updated once
+    // per second.
+
+    bool fShow = !m_diagnostics.is_enabled();
+    m_diagnostics.enable(fShow);
+    if (fShow)
+    {
+        m_hudTimer.Start(1000);
+        update_hud();
+    }
+    else
+    {
+        m_hudTimer.Stop();
+        if (m_toolbar)
+            m_toolbar->set_hud_text(wxEmptyString);
+    }
+    wxLogMessage("[MainFrame::toggle_hud] Diagnostics HUD %s", (fShow ? "enabled" : "disabled"));
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::on_hud_timer(wxTimerEvent& WXUNUSED(event))
+{
+    update_hud();
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::update_hud()
+{
+    if (!m_toolbar)
+        return;
+
+    //the HUD is drawn by the toolbar, after the buttons. Use all the strip width
+    int width = GetClientSize().GetWidth();
+    if (m_toolbar->GetSize().GetWidth() != width)
+        m_toolbar->SetSize(width, m_toolbarHeight);
+
+    m_toolbar->set_hud_text(m_diagnostics.sample());
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::set_cursor(wxStockCursor kind)
+{
+    //Changing the cursor requires a request to the X server. Do it only when the
+    //cursor to display changes, not on each mouse motion event
+    if (kind == m_cursorKind)
+        return;
+
+    m_cursorKind = kind;
+    SetCursor(m_resources.get_cursor(kind));
+}
+
 //---------------------------------------------------------------------------------------
 void MainFrame::on_mouse_left_up(wxMouseEvent& event)
 {
+    TRACE_SCOPE("MainFrame::on_mouse_left_up");
+    record_mouse(k_input_left_up, event);
+    finish_drag();
     if (m_fResizingMode)
     {
         resize_window_left_mouse_up(event);
     }
-    SetCursor(wxCursor(wxCURSOR_ARROW));
+    set_cursor(wxCURSOR_ARROW);
     m_fMoveMode = false;
     event.Skip();
 }
@@ -701,11 +1222,13 @@ void MainFrame::resize_window_mouse_motion(wxMouseEvent& event)
             newGridWidth = static_cast<int>(newGridHeigt * m_aspectRatio);
             newFrameWidth = newGridWidth + borders.x;
         }
-        wxLogMessage("[MainFrame::resize_window_mouse_motion] new grid(%d, %d), aspect ratio %.4f",
+        //wxLogDebug() is removed in Release builds: this message is only filtered by
+        //the module log level, so it can be enabled at runtime
+        wxLogGeneric(wxLOG_Debug, "[MainFrame::resize_window_mouse_motion] new grid(%d, %d), aspect ratio %.4f",
                      newGridWidth, newGridHeigt, (double)newGridWidth/(double)newGridHeigt);
     }
 
-    SetSize(newFrameX, newFrameY, newFrameWidth, newFrameHeight);
+    queue_geometry(wxRect(newFrameX, newFrameY, newFrameWidth, newFrameHeight));
 }
 
 //---------------------------------------------------------------------------------------
@@ -722,6 +1245,110 @@ void MainFrame::resize_window_left_mouse_up(wxMouseEvent& WXUNUSED(event))
         ReleaseMouse();
         m_fMouseCaptured = false;
     }
+
+    //replace the approximate shape by the exact one
+    if (m_fShapeIsApproximate)
+    {
+        m_fMaskIsInvalid = true;
+        refresh_layer_area(k_layer_grid);
+        refresh_layer_area(k_layer_golden_lines);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::start_drag()
+{
+    // Mouse motion while moving or resizing is coalesced: only the latest requested
+    // geometry is kept, and it is applied at most once per display frame by the
+    // drag timer.
+
+    int refreshRate = DEFAULT_REFRESH_RATE;
+    wxDisplay display(this);
+    if (display.IsOk() && display.GetCurrentMode().refresh > 0)
+        refreshRate = display.GetCurrentMode().refresh;
+
+    m_fGeometryPending = false;
+    m_fDragSettled = false;
+    m_lastGeometryTime = std::chrono::steady_clock::now();
+    m_dragTimer.Start(std::max(1000 / refreshRate, 1));
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::queue_geometry(const wxRect& frameRect)
+{
+    //Saves the new frame position and size, to be applied in next display frame.
+    //The latency is measured from the first motion event not yet applied
+    m_pendingGeometry = frameRect;
+    m_fGeometryPending = true;
+    if (!m_fMotionPending)
+    {
+        m_fMotionPending = true;
+        m_motionTime = std::chrono::steady_clock::now();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::apply_pending_geometry()
+{
+    if (m_fGeometryPending)
+    {
+        m_fGeometryPending = false;
+        bool fResized = (m_pendingGeometry.GetSize() != GetSize());
+        if (m_pendingGeometry != GetRect())
+        {
+            SetSize(m_pendingGeometry.x, m_pendingGeometry.y,
+                    m_pendingGeometry.width, m_pendingGeometry.height);
+            m_fDragSettled = false;
+            m_lastGeometryTime = std::chrono::steady_clock::now();
+
+            //a resize is visible after next paint, that also sets the shape. A move
+            //does not need a paint. If a previous geometry is not yet painted, keep
+            //its time
+            if (m_fMotionPending && fResized)
+            {
+                if (!m_fPresentPending)
+                    m_presentTime = m_motionTime;
+                m_fPresentPending = true;
+            }
+            else if (m_fMotionPending)
+            {
+                m_dragLatency.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        m_lastGeometryTime - m_motionTime).count());
+            }
+        }
+        m_fMotionPending = false;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::on_drag_timer(wxTimerEvent& WXUNUSED(event))
+{
+    TRACE_SCOPE("MainFrame::on_drag_timer");
+    apply_pending_geometry();
+
+    //when the user stops moving the mouse while resizing, apply the exact shape
+    if (m_fShapeIsApproximate && !m_fDragSettled)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - m_lastGeometryTime);
+        if (elapsed.count() >= DRAG_SETTLE_MS)
+        {
+            m_fDragSettled = true;
+            m_fMaskIsInvalid = true;
+            refresh_layer_area(k_layer_grid);
+            refresh_layer_area(k_layer_golden_lines);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::finish_drag()
+{
+    if (m_dragTimer.IsRunning())
+    {
+        m_dragTimer.Stop();
+        apply_pending_geometry();
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -741,6 +1368,7 @@ void MainFrame::compute_aspect_ratio()
 //---------------------------------------------------------------------------------------
 void MainFrame::on_about(wxCommandEvent& WXUNUSED(event))
 {
+    TRACE_SCOPE("MainFrame::on_about");
     AboutDialog dlg(this);
     dlg.ShowModal();
 }
@@ -748,11 +1376,19 @@ void MainFrame::on_about(wxCommandEvent& WXUNUSED(event))
 //---------------------------------------------------------------------------------------
 void MainFrame::on_tool_grid_options(wxCommandEvent& WXUNUSED(event))
 {
+    TRACE_SCOPE("MainFrame::on_tool_grid_options");
     DlgGridOptions dlg(this, m_gridSize, m_gridLineThickness, m_gridLinesColour,
                        m_goldenLinesColour, m_toolbarColour, m_frameColour);
 
     if (dlg.ShowModal() == wxID_OK)
     {
+        int gridSize = m_gridSize;
+        int lineThickness = m_gridLineThickness;
+        wxColour gridLinesColour = m_gridLinesColour;
+        wxColour goldenLinesColour = m_goldenLinesColour;
+        wxColour toolbarColour = m_toolbarColour;
+        wxColour frameColour = m_frameColour;
+
         m_gridSize = dlg.get_segments();
         m_gridLineThickness = dlg.get_line_thickness();
         m_gridLinesColour = dlg.get_grid_line_color();
@@ -761,15 +1397,32 @@ void MainFrame::on_tool_grid_options(wxCommandEvent& WXUNUSED(event))
         m_frameColour = dlg.get_frame_color();
         change_black_colours();
 
-        m_fBitmapIsInvalid = true;
+        //rebuild and repaint only the layers affected by the changes
+        GeometryTransaction transaction(this);
+        if (m_gridLineThickness != lineThickness)
+        {
+            transaction.invalidate_layer(k_layer_grid);
+            transaction.invalidate_layer(k_layer_golden_lines);
+            transaction.invalidate_layer(k_layer_border);
+        }
+        if (m_gridSize != gridSize || m_gridLinesColour != gridLinesColour)
+            transaction.invalidate_layer(k_layer_grid);
+        if (m_goldenLinesColour != goldenLinesColour)
+            transaction.invalidate_layer(k_layer_golden_lines);
+        if (m_toolbarColour != toolbarColour)
+            transaction.invalidate_layer(k_layer_toolbar);
+        if (m_frameColour != frameColour)
+            transaction.invalidate_layer(k_layer_frame);
+        transaction.commit();
+
         m_toolbar->change_colour(m_toolbarColour);
-        Refresh();  //trigger repaint
     }
 }
 
 //---------------------------------------------------------------------------------------
 void MainFrame::on_tool_set_aspect_ratio(wxCommandEvent& WXUNUSED(event))
 {
+    TRACE_SCOPE("MainFrame::on_tool_set_aspect_ratio");
     compute_aspect_ratio();
     DlgAspectRatio dlg(this, m_aspectRatio);
     if (dlg.ShowModal() == wxID_OK)
@@ -777,50 +1430,142 @@ void MainFrame::on_tool_set_aspect_ratio(wxCommandEvent& WXUNUSED(event))
         double aspectRatio = dlg.get_aspect_ratio();
         wxConfigBase* pPrefs = wxGetApp().get_preferences();
         pPrefs->Write("/Size/Ratio", aspectRatio);
+        wxGetApp().save_preferences();
         change_and_lock_aspect_ratio(aspectRatio);
-        m_fBitmapIsInvalid = true;
     }
 }
 
 //---------------------------------------------------------------------------------------
 void MainFrame::on_tool_lock_aspect_ratio(wxCommandEvent& event)
 {
+    TRACE_SCOPE("MainFrame::on_tool_lock_aspect_ratio");
+    record_tool(event);
     m_fAspectRatioLocked = event.IsChecked();
 }
 
 //---------------------------------------------------------------------------------------
 void MainFrame::on_tool_show_frame(wxCommandEvent& event)
 {
-    m_fDrawFrame = !event.IsChecked();
-
-    wxSize size = GetSize();
-    wxPoint pos = GetPosition();
-    pos.x += (m_fDrawFrame ? -m_frameThickness : m_frameThickness);
-    pos.y += (m_fDrawFrame ? -m_frameThickness : m_frameThickness);
-    m_fDrawFrame ? size.IncBy(2*m_frameThickness) : size.DecBy(2*m_frameThickness);
-    SetSize(size);
-    SetPosition(pos);
-    m_fBitmapIsInvalid = true;
-    Refresh();
+    TRACE_SCOPE("MainFrame::on_tool_show_frame");
+    record_tool(event);
+    GeometryTransaction transaction(this);
+    transaction.show_frame(!event.IsChecked());
 }
 
 //---------------------------------------------------------------------------------------
 void MainFrame::on_tool_show_grid(wxCommandEvent& event)
 {
-    m_fDrawGrid = !event.IsChecked();
-    m_fBitmapIsInvalid = true;
-    Refresh();
+    TRACE_SCOPE("MainFrame::on_tool_show_grid");
+    record_tool(event);
+    GeometryTransaction transaction(this);
+    transaction.show_grid(!event.IsChecked());
 }
 
 //---------------------------------------------------------------------------------------
 void MainFrame::on_tool_show_golden_lines(wxCommandEvent& event)
 {
-    m_fDrawGoldenLines = !event.IsChecked();
-    m_fBitmapIsInvalid = true;
-    Refresh();
+    TRACE_SCOPE("MainFrame::on_tool_show_golden_lines");
+    record_tool(event);
+    GeometryTransaction transaction(this);
+    transaction.show_golden_lines(!event.IsChecked());
 }
 
 
 
+
+//=======================================================================================
+// MainFrame::GeometryTransaction implementation
+//=======================================================================================
+MainFrame::GeometryTransaction::GeometryTransaction(MainFrame* pFrame)
+    : m_pFrame(pFrame)
+    , m_rect(pFrame->GetRect())
+    , m_decorations(pFrame->GetSize() - pFrame->GetClientSize())
+{
+}
+
+//---------------------------------------------------------------------------------------
+MainFrame::GeometryTransaction::~GeometryTransaction()
+{
+    commit();
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::GeometryTransaction::set_client_size(const wxSize& size)
+{
+    m_rect.SetSize(size + m_decorations);
+}
+
+//---------------------------------------------------------------------------------------
+wxSize MainFrame::GeometryTransaction::get_client_size() const
+{
+    return m_rect.GetSize() - m_decorations;
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::GeometryTransaction::show_frame(bool fShow)
+{
+    //the frame is added around the grid: the grid keeps its place on the screen
+    if (fShow == m_pFrame->m_fDrawFrame)
+        return;
+
+    m_pFrame->m_fDrawFrame = fShow;
+    m_rect.Inflate(fShow ? m_pFrame->m_frameThickness : -m_pFrame->m_frameThickness);
+    m_fAllLayers = true;
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::GeometryTransaction::show_grid(bool fShow)
+{
+    if (fShow == m_pFrame->m_fDrawGrid)
+        return;
+
+    m_pFrame->m_fDrawGrid = fShow;
+    invalidate_layer(k_layer_grid);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::GeometryTransaction::show_golden_lines(bool fShow)
+{
+    if (fShow == m_pFrame->m_fDrawGoldenLines)
+        return;
+
+    m_pFrame->m_fDrawGoldenLines = fShow;
+    invalidate_layer(k_layer_golden_lines);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::GeometryTransaction::invalidate_layer(int layer)
+{
+    if (std::find(m_layers.begin(), m_layers.end(), layer) == m_layers.end())
+        m_layers.push_back(layer);
+}
+
+//---------------------------------------------------------------------------------------
+void MainFrame::GeometryTransaction::commit()
+{
+    if (m_fCommitted)
+        return;
+    m_fCommitted = true;
+
+    TRACE_SCOPE("MainFrame::GeometryTransaction::commit");
+    if (m_rect != m_pFrame->GetRect())
+    {
+        //position and size in a single configure. The shape is rebuilt in next paint
+        m_pFrame->SetSize(m_rect.x, m_rect.y, m_rect.width, m_rect.height);
+        m_pFrame->invalidate_all_layers();
+        m_pFrame->Refresh();
+    }
+    else if (m_fAllLayers)
+    {
+        m_pFrame->invalidate_all_layers();
+        m_pFrame->Refresh();
+    }
+    else if (!m_layers.empty())
+    {
+        m_pFrame->refresh_layers(m_layers);
+    }
+}
+
+
 }   //namespace agrilla
 
@@ -0,0 +1,238 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//wxWidgets
+#include <wx/graphics.h>
+#include <wx/rawbmp.h>
+
+//agrilla
+#include "PaintBackend.h"
+#include "Tracer.h"
+
+//std
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+PaintBackend* PaintBackend::create(const wxString& name, ResourceCache& resources)
+{
+    if (name == "gc")
+        return new GcPaintBackend(resources);
+    if (name == "dc")
+        return new DcPaintBackend(resources);
+    if (name == "raster")
+        return new RasterPaintBackend();
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+wxArrayString PaintBackend::get_names()
+{
+    //the first one is the reference for comparing the output of the others
+    wxArrayString names;
+    names.Add("dc");
+    names.Add("gc");
+    names.Add("raster");
+    return names;
+}
+
+
+//=======================================================================================
+// GcPaintBackend implementation
+//=======================================================================================
+void GcPaintBackend::paint(wxDC& dc, const RenderLayer* pLayers, const wxRegion& damaged,
+                           unsigned char linesAlpha)
+{
+    //Cairo fills a path of pixel aligned rectangles as boxes, without rasterizing
+    //edges, so the cost is in the pixels written and not in the number of calls.
+
+    TRACE_SCOPE("GcPaintBackend::paint");
+    std::unique_ptr<wxGraphicsContext> gc(wxGraphicsContext::CreateFromUnknownDC(dc));
+    if (!gc)
+        return;
+
+    gc->SetPen(*wxTRANSPARENT_PEN);
+    gc->SetAntialiasMode(wxANTIALIAS_NONE);
+
+    wxGraphicsPath path = gc->CreatePath();
+    wxColour pathColour;
+    bool fPathIsEmpty = true;
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        bool fTranslucent = (linesAlpha != 255
+                             && (i == k_layer_grid || i == k_layer_golden_lines));
+        for (const FilledRect& filled : pLayers[i].rects)
+        {
+            if (damaged.Contains(filled.rect) == wxOutRegion)
+                continue;
+
+            wxColour colour = filled.colour;
+            if (fTranslucent)
+                colour.Set(colour.Red(), colour.Green(), colour.Blue(), linesAlpha);
+
+            //a change of colour: fill the rectangles collected so far
+            if (!fPathIsEmpty && colour != pathColour)
+            {
+                gc->SetBrush(m_resources.get_brush(pathColour));
+                gc->FillPath(path, wxWINDING_RULE);
+                path = gc->CreatePath();
+            }
+
+            pathColour = colour;
+            path.AddRectangle(filled.rect.x, filled.rect.y, filled.rect.width,
+                              filled.rect.height);
+            fPathIsEmpty = false;
+        }
+    }
+
+    if (!fPathIsEmpty)
+    {
+        gc->SetBrush(m_resources.get_brush(pathColour));
+        gc->FillPath(path, wxWINDING_RULE);
+    }
+}
+
+
+//=======================================================================================
+// DcPaintBackend implementation
+//=======================================================================================
+void DcPaintBackend::paint(wxDC& dc, const RenderLayer* pLayers, const wxRegion& damaged,
+                           unsigned char WXUNUSED(linesAlpha))
+{
+    TRACE_SCOPE("DcPaintBackend::paint");
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    wxColour brushColour = *wxBLACK;
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        for (const FilledRect& filled : pLayers[i].rects)
+        {
+            if (damaged.Contains(filled.rect) == wxOutRegion)
+                continue;
+
+            if (filled.colour != brushColour)
+            {
+                brushColour = filled.colour;
+                dc.SetBrush(m_resources.get_brush(brushColour));
+            }
+            dc.DrawRectangle(filled.rect);
+        }
+    }
+}
+
+
+//=======================================================================================
+// RasterPaintBackend implementation
+//=======================================================================================
+void RasterPaintBackend::paint(wxDC& dc, const RenderLayer* pLayers, const wxRegion& damaged,
+                               unsigned char WXUNUSED(linesAlpha))
+{
+    //m_bitmap holds the pixels of the window, from (0, 0). Each rectangle of the
+    //damaged region is rasterized in it by PixelRasterizer, and then the pixels written
+    //there are blitted. The pixels not covered by any layer rectangle are outside the
+    //window shape: they are neither cleared nor drawn.
+
+    TRACE_SCOPE("RasterPaintBackend::paint");
+    wxRect box = damaged.GetBox();
+    if (box.IsEmpty())
+        return;
+
+    reserve_bitmap(box.GetRight() + 1, box.GetBottom() + 1);
+
+    std::vector<wxRect> blits;
+    {
+        wxNativePixelData data(m_bitmap);
+        if (!data)
+            return;
+
+        PixelBuffer buffer = get_pixel_buffer(data, wxRect(wxPoint(0, 0),
+                                                           m_bitmap.GetSize()));
+        std::vector<wxRect> coverage;
+        for (wxRegionIterator it(damaged); it; ++it)
+        {
+            coverage.clear();
+            PixelRasterizer::fill_layers(buffer, pLayers, it.GetRect(), &coverage);
+            if (coverage.empty())
+                continue;
+
+            wxRect written = coverage.front();
+            for (const wxRect& rect : coverage)
+                written.Union(rect);
+            blits.push_back(written);
+        }
+    }   //the pixels are released before drawing the bitmap
+
+    if (blits.empty())
+        return;
+
+    wxMemoryDC memDC(m_bitmap);
+    for (const wxRect& rect : blits)
+    {
+        dc.Blit(rect.x, rect.y, rect.width, rect.height, &memDC, rect.x, rect.y);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void RasterPaintBackend::reserve_bitmap(int width, int height)
+{
+    //The bitmap only grows, and by at least half its size, so that resizing the window
+    //recreates it a few times and not on every paint. Its previous content is not
+    //needed, as all the pixels drawn are rasterized again.
+
+    if (m_bitmap.IsOk() && m_bitmap.GetWidth() >= width && m_bitmap.GetHeight() >= height)
+        return;
+
+    if (m_bitmap.IsOk())
+    {
+        width = std::max(width, m_bitmap.GetWidth() * 3 / 2);
+        height = std::max(height, m_bitmap.GetHeight() * 3 / 2);
+    }
+    m_bitmap.Create(width, height, 24);
+}
+
+//---------------------------------------------------------------------------------------
+PixelBuffer RasterPaintBackend::get_pixel_buffer(wxNativePixelData& data,
+                                                 const wxRect& area)
+{
+    wxNativePixelData::Iterator origin(data);
+    PixelBuffer buffer;
+    buffer.pData = origin.m_ptr;
+    buffer.stride = data.GetRowStride();
+    buffer.left = area.x;
+    buffer.top = area.y;
+    buffer.width = area.width;
+    buffer.height = area.height;
+    buffer.pixelSize = wxNativePixelFormat::SizePixel;
+    buffer.red = wxNativePixelFormat::RED;
+    buffer.green = wxNativePixelFormat::GREEN;
+    buffer.blue = wxNativePixelFormat::BLUE;
+    return buffer;
+}
+
+//---------------------------------------------------------------------------------------
+size_t RasterPaintBackend::get_memory_bytes() const
+{
+    if (!m_bitmap.IsOk())
+        return 0;
+    return size_t(m_bitmap.GetWidth()) * m_bitmap.GetHeight()
+           * wxNativePixelFormat::SizePixel;
+}
+
+
+} // namespace agrilla
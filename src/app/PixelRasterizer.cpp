@@ -0,0 +1,310 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "PixelRasterizer.h"
+
+//std
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+//SIMD. SSE2 is always available in x86-64. AVX2 is used when the CPU has it, and
+//requires GCC or Clang to compile a single function for it
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define AGRILLA_FILL_SSE2 1
+#endif
+#if defined(AGRILLA_FILL_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define AGRILLA_FILL_AVX2 1
+#endif
+
+
+namespace agrilla
+{
+
+const int PixelPattern::k_size;
+const int PixelRasterizer::k_column_max_pixels;
+const size_t PixelRasterizer::k_stream_bytes;
+
+namespace
+{
+    typedef void (*RowsFill)(unsigned char* pRow, int stride, int numRows, size_t numBytes,
+                             const PixelPattern& pattern);
+
+    //-----------------------------------------------------------------------------------
+    void fill_rows_scalar(unsigned char* pRow, int stride, int numRows, size_t numBytes,
+                          const PixelPattern& pattern)
+    {
+        //fixed-size copies: the compiler uses the widest stores it can
+        for (int y = 0; y < numRows; ++y, pRow += stride)
+        {
+            unsigned char* p = pRow;
+            size_t rest = numBytes;
+            for (; rest >= size_t(PixelPattern::k_size); rest -= PixelPattern::k_size)
+            {
+                std::memcpy(p, pattern.bytes, PixelPattern::k_size);
+                p += PixelPattern::k_size;
+            }
+            std::memcpy(p, pattern.bytes, rest);
+        }
+    }
+
+#if defined(AGRILLA_FILL_SSE2)
+    //-----------------------------------------------------------------------------------
+    void fill_rows_sse2(unsigned char* pRow, int stride, int numRows, size_t numBytes,
+                        const PixelPattern& pattern)
+    {
+        //Stores are aligned: the first bytes are copied, and the pattern is taken from
+        //that offset. Big fills use streaming stores, that do not read the memory
+        //before writing it nor evict the cache
+        bool fStream = (numBytes * numRows >= PixelRasterizer::k_stream_bytes);
+        for (int y = 0; y < numRows; ++y, pRow += stride)
+        {
+            unsigned char* p = pRow;
+            size_t rest = numBytes;
+            size_t head = std::min(size_t(-reinterpret_cast<uintptr_t>(p) & 15), rest);
+            std::memcpy(p, pattern.bytes, head);
+            p += head;
+            rest -= head;
+
+            const unsigned char* pPattern = pattern.bytes + head;
+            __m128i v[6];
+            for (int i = 0; i < 6; ++i)
+                v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPattern + 16 * i));
+
+            if (fStream)
+            {
+                for (; rest >= 96; rest -= 96, p += 96)
+                {
+                    for (int i = 0; i < 6; ++i)
+                        _mm_stream_si128(reinterpret_cast<__m128i*>(p + 16 * i), v[i]);
+                }
+            }
+            else
+            {
+                for (; rest >= 96; rest -= 96, p += 96)
+                {
+                    for (int i = 0; i < 6; ++i)
+                        _mm_store_si128(reinterpret_cast<__m128i*>(p + 16 * i), v[i]);
+                }
+            }
+            int i = 0;
+            for (; rest >= 16; rest -= 16, p += 16, ++i)
+            {
+                _mm_store_si128(reinterpret_cast<__m128i*>(p), v[i]);
+            }
+            std::memcpy(p, pPattern + 16 * i, rest);
+        }
+        if (fStream)
+            _mm_sfence();
+    }
+#endif
+
+#if defined(AGRILLA_FILL_AVX2)
+    //-----------------------------------------------------------------------------------
+    __attribute__((target("avx2")))
+    void fill_rows_avx2(unsigned char* pRow, int stride, int numRows, size_t numBytes,
+                        const PixelPattern& pattern)
+    {
+        //as fill_rows_sse2(), with 32 byte stores
+        bool fStream = (numBytes * numRows >= PixelRasterizer::k_stream_bytes);
+        for (int y = 0; y < numRows; ++y, pRow += stride)
+        {
+            unsigned char* p = pRow;
+            size_t rest = numBytes;
+            size_t head = std::min(size_t(-reinterpret_cast<uintptr_t>(p) & 31), rest);
+            std::memcpy(p, pattern.bytes, head);
+            p += head;
+            rest -= head;
+
+            const unsigned char* pPattern = pattern.bytes + head;
+            __m256i v[3];
+            for (int i = 0; i < 3; ++i)
+                v[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pPattern + 32 * i));
+
+            if (fStream)
+            {
+                for (; rest >= 96; rest -= 96, p += 96)
+                {
+                    for (int i = 0; i < 3; ++i)
+                        _mm256_stream_si256(reinterpret_cast<__m256i*>(p + 32 * i), v[i]);
+                }
+            }
+            else
+            {
+                for (; rest >= 96; rest -= 96, p += 96)
+                {
+                    for (int i = 0; i < 3; ++i)
+                        _mm256_store_si256(reinterpret_cast<__m256i*>(p + 32 * i), v[i]);
+                }
+            }
+            int i = 0;
+            for (; rest >= 32; rest -= 32, p += 32, ++i)
+            {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(p), v[i]);
+            }
+            std::memcpy(p, pPattern + 32 * i, rest);
+        }
+        if (fStream)
+            _mm_sfence();
+    }
+#endif
+
+    //-----------------------------------------------------------------------------------
+    struct RowsFillKernel
+    {
+        RowsFill fill;
+        const char* name;
+    };
+
+    const RowsFillKernel& get_rows_fill()
+    {
+        //selected once, for the CPU running the program
+        static const RowsFillKernel kernel = []() {
+#if defined(AGRILLA_FILL_AVX2)
+            if (__builtin_cpu_supports("avx2"))
+                return RowsFillKernel{ &fill_rows_avx2, "avx2" };
+#endif
+#if defined(AGRILLA_FILL_SSE2)
+            return RowsFillKernel{ &fill_rows_sse2, "sse2" };
+#else
+            return RowsFillKernel{ &fill_rows_scalar, "scalar" };
+#endif
+        }();
+        return kernel;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void PixelRasterizer::make_pattern(const PixelBuffer& buffer, unsigned char red,
+                                   unsigned char green, unsigned char blue,
+                                   PixelPattern& pattern)
+{
+    //k_size is a multiple of 3 and 4: the pattern holds whole pixels, and it goes on
+    //in the extra bytes, for starting it at an offset
+    pattern.pixelSize = buffer.pixelSize;
+    std::memset(pattern.bytes, 0xFF, sizeof(pattern.bytes));     //alpha, if any
+    for (int i = 0; i + buffer.pixelSize <= int(sizeof(pattern.bytes)); i += buffer.pixelSize)
+    {
+        pattern.bytes[i + buffer.red] = red;
+        pattern.bytes[i + buffer.green] = green;
+        pattern.bytes[i + buffer.blue] = blue;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void PixelRasterizer::fill_rows(unsigned char* pRow, int stride, int numRows,
+                                int numPixels, const PixelPattern& pattern)
+{
+    get_rows_fill().fill(pRow, stride, numRows, size_t(numPixels) * pattern.pixelSize,
+                         pattern);
+}
+
+//---------------------------------------------------------------------------------------
+void PixelRasterizer::fill_columns(const PixelBuffer& buffer, const std::vector<wxRect>& rects,
+                                   const PixelPattern& pattern)
+{
+    //The rectangles are narrow, and have the same rows. They are filled row by row,
+    //all of them in each row: the memory is written in order, and the hardware
+    //prefetcher can follow it. Filling each column from top to bottom is about three
+    //times slower, as each row is a cache miss.
+    //Each row of a rectangle is a few bytes, at most k_column_max_pixels pixels: they
+    //are copied without the setup of a row fill.
+
+    if (rects.empty())
+        return;
+
+    const wxRect& first = rects.front();
+    unsigned char* pRow = buffer.pData + ptrdiff_t(first.y - buffer.top) * buffer.stride;
+    for (int y = 0; y < first.height; ++y, pRow += buffer.stride)
+    {
+        for (const wxRect& rect : rects)
+        {
+            unsigned char* p = pRow + ptrdiff_t(rect.x - buffer.left) * buffer.pixelSize;
+            int numBytes = rect.width * buffer.pixelSize;
+            for (int i = 0; i < numBytes; ++i)
+                p[i] = pattern.bytes[i];
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void PixelRasterizer::fill_rect(const PixelBuffer& buffer, const wxRect& rect,
+                                const PixelPattern& pattern)
+{
+    unsigned char* pRow = buffer.pData + ptrdiff_t(rect.y - buffer.top) * buffer.stride
+                          + ptrdiff_t(rect.x - buffer.left) * buffer.pixelSize;
+    fill_rows(pRow, buffer.stride, rect.height, rect.width, pattern);
+}
+
+//---------------------------------------------------------------------------------------
+void PixelRasterizer::fill_layers(const PixelBuffer& buffer, const RenderLayer* pLayers,
+                                  const wxRect& area, std::vector<wxRect>* pCoverage)
+{
+    //Wide rectangles are filled as rows. Consecutive narrow rectangles of the same
+    //colour and rows, such as the vertical grid lines, are collected and filled
+    //together as columns. The pattern is only rebuilt when the colour changes.
+
+    wxRect clip = area.Intersect(wxRect(buffer.left, buffer.top, buffer.width,
+                                        buffer.height));
+    PixelPattern pattern;
+    wxColour patternColour;
+    std::vector<wxRect> columns;
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        for (const FilledRect& filled : pLayers[i].rects)
+        {
+            wxRect rect = filled.rect.Intersect(clip);
+            if (rect.IsEmpty())
+                continue;
+            if (pCoverage)
+                pCoverage->push_back(rect);
+
+            bool fNewColour = (!patternColour.IsOk() || filled.colour != patternColour);
+            bool fColumn = (rect.width <= k_column_max_pixels);
+            if (!columns.empty() && (fNewColour || !fColumn
+                                     || rect.y != columns.front().y
+                                     || rect.height != columns.front().height))
+            {
+                fill_columns(buffer, columns, pattern);
+                columns.clear();
+            }
+
+            if (fNewColour)
+            {
+                patternColour = filled.colour;
+                make_pattern(buffer, patternColour.Red(), patternColour.Green(),
+                             patternColour.Blue(), pattern);
+            }
+
+            if (fColumn)
+                columns.push_back(rect);
+            else
+                fill_rect(buffer, rect, pattern);
+        }
+    }
+    fill_columns(buffer, columns, pattern);
+}
+
+//---------------------------------------------------------------------------------------
+const char* PixelRasterizer::get_row_fill_name()
+{
+    return get_rows_fill().name;
+}
+
+
+} // namespace agrilla
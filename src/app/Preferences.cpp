@@ -0,0 +1,179 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//wxWidgets
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/fileconf.h>
+#include <wx/mstream.h>
+#include <wx/log.h>
+
+//agrilla
+#include "Preferences.h"
+
+//std
+#include <chrono>
+
+
+//log messages from this file belong to the 'agrilla/prefs' module
+#define wxLOG_COMPONENT "agrilla/prefs"
+
+
+namespace agrilla
+{
+
+//definition required, as std::chrono::milliseconds() takes it by reference
+const int Preferences::k_batch_delay_ms;
+
+//---------------------------------------------------------------------------------------
+Preferences::Preferences(const wxString& filename)
+    : m_filename(filename)
+{
+    //AWARE: wxFileConfig reads the file here, but it is never used for writing it,
+    //as wxFileConfig::Flush() writes the file synchronously
+    m_pConfig = new wxFileConfig("agrilla", "agrilla", filename, "agrilla",
+                                 wxCONFIG_USE_LOCAL_FILE);
+    wxConfigBase::Set(m_pConfig);
+    m_pConfig->SetRecordDefaults();
+
+    m_thread = std::thread(&Preferences::writer_thread, this);
+}
+
+//---------------------------------------------------------------------------------------
+Preferences::~Preferences()
+{
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fStop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+//---------------------------------------------------------------------------------------
+wxConfigBase* Preferences::get_config()
+{
+    return m_pConfig;
+}
+
+//---------------------------------------------------------------------------------------
+bool Preferences::take_snapshot()
+{
+    //Serializes the configuration in memory. This also clears the wxFileConfig dirty
+    //flag, so that it will not write the file when deleted.
+    wxMemoryOutputStream stream;
+    if (!m_pConfig->Save(stream))
+    {
+        wxLogError("[Preferences::take_snapshot] Failed to serialize the preferences.");
+        return false;
+    }
+
+    std::string content(stream.GetSize(), '\0');
+    if (!content.empty())
+        stream.CopyTo(&content[0], content.size());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot.swap(content);
+    m_fPending = true;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void Preferences::save()
+{
+    //Requests to write the current values. It doesn't wait for the file to be written
+    if (take_snapshot())
+        m_cv.notify_all();
+}
+
+//---------------------------------------------------------------------------------------
+void Preferences::flush()
+{
+    //Writes any pending change and waits until the file is written
+    take_snapshot();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_fFlush = true;
+    m_cv.notify_all();
+    m_cv.wait(lock, [this]() { return (!m_fPending && !m_fWriting) || !m_thread.joinable(); });
+    m_fFlush = false;
+}
+
+//---------------------------------------------------------------------------------------
+void Preferences::writer_thread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this]() { return m_fPending || m_fStop; });
+        if (!m_fPending && m_fStop)
+            break;
+
+        //wait a bit, to batch several changes in a single write. The notifications
+        //of further saves do not end the wait. When exiting, or when a flush is
+        //waiting, write it now
+        m_cv.wait_for(lock, std::chrono::milliseconds(k_batch_delay_ms),
+                      [this]() { return m_fStop || m_fFlush; });
+
+        std::string content;
+        content.swap(m_snapshot);
+        m_fPending = false;
+        m_fWriting = true;
+
+        lock.unlock();
+        write_file(content);
+        lock.lock();
+
+        m_fWriting = false;
+        m_cv.notify_all();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+bool Preferences::write_file(const std::string& content)
+{
+    //Runs in the writer thread. The content is written to a temporary file that then
+    //replaces the preferences file. The temporary file is synced to disk before
+    //rename(), that is atomic (wxFile::Flush() calls fsync()): a crash, a power loss
+    //or a full disk never leave a truncated preferences file.
+
+    wxString tmpName = m_filename + ".tmp";
+    {
+        wxFile file;
+        if (!file.Create(tmpName, true /*overwrite*/)
+            || file.Write(content.data(), content.size()) != content.size()
+            || !file.Flush() || !file.Close())
+        {
+            wxLogError("[Preferences::write_file] Could not write file '%s'", tmpName);
+            file.Close();
+            wxRemoveFile(tmpName);
+            return false;
+        }
+    }
+
+    if (!wxRenameFile(tmpName, m_filename, true /*overwrite*/))
+    {
+        wxLogError("[Preferences::write_file] Could not rename '%s' as '%s'", tmpName,
+                   m_filename);
+        wxRemoveFile(tmpName);
+        return false;
+    }
+    return true;
+}
+
+
+} // namespace agrilla
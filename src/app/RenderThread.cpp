@@ -0,0 +1,113 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "RenderThread.h"
+#include "Tracer.h"
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+RenderThread::RenderThread(wxEvtHandler* pOwner, int id)
+    : m_pOwner(pOwner)
+    , m_id(id)
+{
+    m_thread = std::thread(&RenderThread::worker_thread, this);
+}
+
+//---------------------------------------------------------------------------------------
+RenderThread::~RenderThread()
+{
+    stop();
+}
+
+//---------------------------------------------------------------------------------------
+void RenderThread::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fStop = true;
+        m_fJobPending = false;
+    }
+    m_cv.notify_all();
+
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+//---------------------------------------------------------------------------------------
+void RenderThread::submit(const RenderJob& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = job;
+        m_fJobPending = true;
+    }
+    m_cv.notify_all();
+}
+
+//---------------------------------------------------------------------------------------
+std::unique_ptr<RenderResult> RenderThread::take_result()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::move(m_pReady);
+}
+
+//---------------------------------------------------------------------------------------
+void RenderThread::worker_thread()
+{
+    while (true)
+    {
+        RenderJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_fJobPending || m_fStop; });
+            if (m_fStop)
+                return;
+
+            job = m_job;
+            m_fJobPending = false;
+        }
+
+        //build all the layers and the full shape
+        std::unique_ptr<RenderResult> pResult(new RenderResult());
+        {
+            TRACE_SCOPE("RenderThread::build");
+            pResult->job = job;
+            pResult->layout.update(job.options);
+            LayerBuilder::build_dirty_layers(pResult->layout, job.colours, pResult->layers);
+            pResult->shape.clear(wxSize(job.options.width, job.options.height));
+            LayerBuilder::add_to_shape(pResult->layers, { k_layer_toolbar, k_layer_frame,
+                                       k_layer_grid, k_layer_golden_lines, k_layer_border },
+                                       pResult->shape);
+        }
+
+        //publish it, unless it is already outdated. A result not taken by the owner
+        //is replaced, and deleted out of the lock
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_fJobPending || m_fStop)
+                continue;
+            m_pReady.swap(pResult);
+        }
+        pResult.reset();
+        m_pOwner->QueueEvent(new wxThreadEvent(wxEVT_THREAD, m_id));
+    }
+}
+
+
+} // namespace agrilla
@@ -0,0 +1,70 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "ResourceCache.h"
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+uint64_t ResourceCache::make_key(const wxColour& colour, int width, int style)
+{
+    //RGBA in the low 32 bits, then 16 bits for the width and 16 bits for the style
+    uint64_t rgba = (uint64_t(colour.Red()) << 24) | (uint64_t(colour.Green()) << 16)
+                    | (uint64_t(colour.Blue()) << 8) | uint64_t(colour.Alpha());
+    return rgba | (uint64_t(width & 0xFFFF) << 32) | (uint64_t(style & 0xFFFF) << 48);
+}
+
+//---------------------------------------------------------------------------------------
+const wxPen& ResourceCache::get_pen(const wxColour& colour, int width, wxPenStyle style)
+{
+    uint64_t key = make_key(colour, width, style);
+    auto it = m_pens.find(key);
+    if (it == m_pens.end())
+        it = m_pens.emplace(key, wxPen(colour, width, style)).first;
+    return it->second;
+}
+
+//---------------------------------------------------------------------------------------
+const wxBrush& ResourceCache::get_brush(const wxColour& colour, wxBrushStyle style)
+{
+    uint64_t key = make_key(colour, 0, style);
+    auto it = m_brushes.find(key);
+    if (it == m_brushes.end())
+        it = m_brushes.emplace(key, wxBrush(colour, style)).first;
+    return it->second;
+}
+
+//---------------------------------------------------------------------------------------
+const wxCursor& ResourceCache::get_cursor(wxStockCursor kind)
+{
+    auto it = m_cursors.find(kind);
+    if (it == m_cursors.end())
+        it = m_cursors.emplace(kind, wxCursor(kind)).first;
+    return it->second;
+}
+
+//---------------------------------------------------------------------------------------
+void ResourceCache::clear()
+{
+    m_pens.clear();
+    m_brushes.clear();
+    m_cursors.clear();
+}
+
+
+} // namespace agrilla
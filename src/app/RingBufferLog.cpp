@@ -0,0 +1,209 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//wxWidgets
+#include <wx/tokenzr.h>
+
+//agrilla
+#include "RingBufferLog.h"
+
+//std
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+
+//log messages from this file belong to the 'agrilla/log' module
+#define wxLOG_COMPONENT "agrilla/log"
+
+
+namespace agrilla
+{
+
+const int WRITER_PERIOD_MS = 100;       //max time a message waits in the buffer
+
+//---------------------------------------------------------------------------------------
+RingBufferLog::RingBufferLog(FILE* pFile)
+    : m_pFile(pFile)
+    , m_head(0)
+    , m_tail(0)
+    , m_dropped(0)
+    , m_fStop(false)
+{
+    m_thread = std::thread(&RingBufferLog::writer_thread, this);
+}
+
+//---------------------------------------------------------------------------------------
+RingBufferLog::~RingBufferLog()
+{
+    stop();
+}
+
+//---------------------------------------------------------------------------------------
+void RingBufferLog::stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_fStop = true;
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+//---------------------------------------------------------------------------------------
+void RingBufferLog::DoLogRecord(wxLogLevel level, const wxString& msg,
+                                const wxLogRecordInfo& info)
+{
+    //Runs in the main thread. No locks, no allocations (other than the UTF-8
+    //conversion) and no I/O: just copy the message into the next free record
+
+    unsigned head = m_head.load(std::memory_order_relaxed);
+    unsigned tail = m_tail.load(std::memory_order_acquire);
+    if (head - tail >= static_cast<unsigned>(k_num_records) || !m_thread.joinable())
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& record = m_records[head & (k_num_records - 1)];
+    record.timestampMS = info.timestampMS;
+    record.level = level;
+
+    //the component without the 'agrilla/' prefix, common to all
+    const char* component = (info.component ? info.component : "");
+    if (std::strncmp(component, "agrilla/", 8) == 0)
+        component += 8;
+    std::strncpy(record.component, component, k_component_size - 1);
+    record.component[k_component_size - 1] = '\0';
+
+    wxScopedCharBuffer text = msg.utf8_str();
+    size_t length = std::min(text.length(), size_t(k_text_size - 1));
+    std::memcpy(record.text, text.data(), length);
+    record.text[length] = '\0';
+
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+//---------------------------------------------------------------------------------------
+void RingBufferLog::writer_thread()
+{
+    while (!m_fStop)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, std::chrono::milliseconds(WRITER_PERIOD_MS));
+        }
+        write_pending();
+    }
+    write_pending();
+}
+
+//---------------------------------------------------------------------------------------
+void RingBufferLog::write_pending()
+{
+    //Runs in the writer thread. Formats the records as
+    //  HH:MM:SS.mmm L component  text
+    //where L is the level: E(rror), W(arning), M(essage), I(nfo), D(ebug), T(race)
+
+    unsigned tail = m_tail.load(std::memory_order_relaxed);
+    unsigned head = m_head.load(std::memory_order_acquire);
+    if (tail == head && m_dropped.load(std::memory_order_relaxed) == 0)
+        return;
+
+    for (; tail != head; ++tail)
+    {
+        const Record& record = m_records[tail & (k_num_records - 1)];
+
+        std::time_t seconds = static_cast<std::time_t>(record.timestampMS / 1000);
+        std::tm local;
+#if defined(_WIN32)
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+
+        const char* levels = "FEWMSIDT";
+        char level = (record.level < 8 ? levels[record.level] : 'U');
+
+        std::fprintf(m_pFile, "%02d:%02d:%02d.%03d %c %-8s %s\n", local.tm_hour,
+                     local.tm_min, local.tm_sec, int(record.timestampMS % 1000), level,
+                     record.component, record.text);
+
+        //free the record for the producer
+        m_tail.store(tail + 1, std::memory_order_release);
+    }
+
+    unsigned dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+        std::fprintf(m_pFile, "%u log messages dropped. The log buffer was full\n", dropped);
+
+    std::fflush(m_pFile);
+}
+
+//---------------------------------------------------------------------------------------
+bool RingBufferLog::parse_level(const wxString& name, wxLogLevel* pLevel)
+{
+    static const struct { const char* name; wxLogLevel level; } k_levels[] = {
+        { "none", wxLOG_FatalError },
+        { "error", wxLOG_Error },
+        { "warning", wxLOG_Warning },
+        { "message", wxLOG_Message },
+        { "info", wxLOG_Info },
+        { "debug", wxLOG_Debug },
+        { "trace", wxLOG_Trace },
+    };
+
+    for (const auto& entry : k_levels)
+    {
+        if (name.IsSameAs(entry.name, false))
+        {
+            *pLevel = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+void RingBufferLog::set_levels(const wxString& spec)
+{
+    //Spec is a comma separated list of 'module=level' items. Module is the log
+    //component without the 'agrilla/' prefix, or '*' for all modules. Level is one
+    //of: none, error, warning, message, info, debug, trace.
+
+    wxStringTokenizer tokens(spec, ",");
+    while (tokens.HasMoreTokens())
+    {
+        wxString item = tokens.GetNextToken().Trim(true).Trim(false);
+        wxString module = item.BeforeFirst('=').Trim(true);
+        wxString levelName = item.AfterFirst('=').Trim(false);
+
+        wxLogLevel level;
+        if (!parse_level(levelName, &level))
+        {
+            wxLogWarning("[RingBufferLog::set_levels] Invalid log level in '%s'", item);
+            continue;
+        }
+
+        if (module == "*")
+            wxLog::SetComponentLevel("agrilla", level);
+        else
+            wxLog::SetComponentLevel("agrilla/" + module, level);
+    }
+}
+
+
+} // namespace agrilla
@@ -0,0 +1,188 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//wxWidgets
+#include <wx/region.h>
+#include <wx/log.h>
+
+//agrilla
+#include "ShapeBuilder.h"
+#include "Tracer.h"
+
+//X11. Must be included after wxWidgets headers, as X11 defines macros such as
+//'None', 'Bool' or 'Status' that collide with wxWidgets names
+#if defined(AGRILLA_USE_XSHAPE) && defined(__WXGTK3__)
+    #include <gtk/gtk.h>
+    #include <gdk/gdkx.h>
+    #include <X11/extensions/shape.h>
+#endif
+
+
+//log messages from this file belong to the 'agrilla/shape' module
+#define wxLOG_COMPONENT "agrilla/shape"
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+void ShapeBuilder::clear(const wxSize& bounds)
+{
+    m_bounds = wxRect(wxPoint(0, 0), bounds);
+    m_rects.clear();
+    m_fRegionValid = false;
+}
+
+//---------------------------------------------------------------------------------------
+void ShapeBuilder::add_rect(const wxRect& rect)
+{
+    //rectangles partially outside the window are clipped. Empty ones are ignored
+    wxRect clipped = rect.Intersect(m_bounds);
+    if (!clipped.IsEmpty())
+    {
+        m_rects.push_back(clipped);
+        m_fRegionValid = false;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+wxRegion ShapeBuilder::build_region() const
+{
+    TRACE_SCOPE("ShapeBuilder::build_region");
+    wxRegion rgn;
+    for (const wxRect& rect : m_rects)
+    {
+        rgn.Union(rect);
+    }
+    return rgn;
+}
+
+//---------------------------------------------------------------------------------------
+const wxRegion& ShapeBuilder::get_region() const
+{
+    if (!m_fRegionValid)
+    {
+        m_region = build_region();
+        m_fRegionValid = true;
+    }
+    return m_region;
+}
+
+//---------------------------------------------------------------------------------------
+bool ShapeBuilder::apply_to(wxNonOwnedWindow* pWindow) const
+{
+    //Returns true if the shape has been applied to the window. When false, the
+    //window stays unshaped (or keeps its previous shape), as there is no fallback
+
+    if (m_rects.empty())
+        return false;
+
+#if defined(AGRILLA_USE_XSHAPE) && defined(__WXGTK3__)
+    if (apply_with_xshape(pWindow, ShapeBounding))
+        return true;
+#endif
+
+    const wxRegion& rgn = get_region();
+    TRACE_SCOPE("SetShape");
+    return pWindow->SetShape(rgn);
+}
+
+//---------------------------------------------------------------------------------------
+bool ShapeBuilder::apply_input_to(wxNonOwnedWindow* pWindow) const
+{
+    //Sets the rectangles as the input shape of the window, without changing its
+    //visible shape. Returns false if not supported or the window is not yet realized
+
+    if (m_rects.empty())
+        return false;
+
+#if defined(AGRILLA_USE_XSHAPE) && defined(__WXGTK3__)
+    return apply_with_xshape(pWindow, ShapeInput);
+#else
+    wxUnusedVar(pWindow);
+    return false;
+#endif
+}
+
+//---------------------------------------------------------------------------------------
+bool ShapeBuilder::has_input_shape_support()
+{
+    return has_shape_extension();
+}
+
+//---------------------------------------------------------------------------------------
+bool ShapeBuilder::has_shape_extension()
+{
+    //An X server without the Shape extension raises an X error on
+    //XShapeCombineRectangles() instead of returning an error, so it is checked once,
+    //before using it
+#if defined(AGRILLA_USE_XSHAPE) && defined(__WXGTK3__)
+    static int fSupported = -1;     //not yet checked
+    if (fSupported < 0)
+    {
+        GdkDisplay* display = gdk_display_get_default();
+        int eventBase, errorBase;
+        fSupported = (display && GDK_IS_X11_DISPLAY(display)
+                      && XShapeQueryExtension(GDK_DISPLAY_XDISPLAY(display),
+                                              &eventBase, &errorBase)) ? 1 : 0;
+        if (!fSupported)
+            wxLogMessage("[ShapeBuilder::has_shape_extension] No X11 Shape extension");
+    }
+    return fSupported == 1;
+#else
+    return false;
+#endif
+}
+
+//---------------------------------------------------------------------------------------
+bool ShapeBuilder::apply_with_xshape(wxNonOwnedWindow* pWindow, int kind) const
+{
+    TRACE_SCOPE("ShapeBuilder::apply_with_xshape");
+#if defined(AGRILLA_USE_XSHAPE) && defined(__WXGTK3__)
+    //The X11 window only exists after the frame is realized. Before that, and when
+    //running on Wayland, wxWidgets must be used
+    GtkWidget* widget = static_cast<GtkWidget*>(pWindow->GetHandle());
+    GdkWindow* gdkWindow = (widget ? gtk_widget_get_window(widget) : nullptr);
+    if (gdkWindow == nullptr || !GDK_IS_X11_WINDOW(gdkWindow) || !has_shape_extension())
+        return false;
+
+    //reused, to avoid allocating memory on each shape change while dragging. Shapes
+    //are only set from the main thread
+    static std::vector<XRectangle> xrects;
+    xrects.clear();
+    for (const wxRect& rect : m_rects)
+    {
+        XRectangle xr;
+        xr.x = static_cast<short>(rect.x);
+        xr.y = static_cast<short>(rect.y);
+        xr.width = static_cast<unsigned short>(rect.width);
+        xr.height = static_cast<unsigned short>(rect.height);
+        xrects.push_back(xr);
+    }
+
+    XShapeCombineRectangles(GDK_WINDOW_XDISPLAY(gdkWindow), GDK_WINDOW_XID(gdkWindow),
+                            kind, 0, 0, xrects.data(),
+                            static_cast<int>(xrects.size()), ShapeSet, Unsorted);
+    return true;
+
+#else
+    wxUnusedVar(pWindow);
+    wxUnusedVar(kind);
+    return false;
+#endif
+}
+
+
+} // namespace agrilla
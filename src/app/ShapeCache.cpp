@@ -0,0 +1,155 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "ShapeCache.h"
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+bool ShapeKey::operator==(const ShapeKey& other) const
+{
+    return width == other.width && height == other.height
+           && toolbarHeight == other.toolbarHeight && gridSize == other.gridSize
+           && lineThickness == other.lineThickness
+           && frameThickness == other.frameThickness
+           && handlerSide == other.handlerSide
+           && colours[0] == other.colours[0] && colours[1] == other.colours[1]
+           && colours[2] == other.colours[2] && colours[3] == other.colours[3]
+           && flags == other.flags;
+}
+
+//---------------------------------------------------------------------------------------
+void ShapeCache::set_budget(size_t bytes)
+{
+    m_budget = bytes;
+    trim(m_budget);
+}
+
+//---------------------------------------------------------------------------------------
+void ShapeCache::clear()
+{
+    m_entries.clear();
+    m_bytes = 0;
+}
+
+//---------------------------------------------------------------------------------------
+bool ShapeCache::contains(const ShapeKey& key) const
+{
+    //does not count as a hit or a miss, and does not change the LRU order
+    for (const Entry& entry : m_entries)
+    {
+        if (entry.key == key)
+            return true;
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+bool ShapeCache::restore(const ShapeKey& key, RenderLayer* pLayers, ShapeBuilder* pShape)
+{
+    if (m_budget == 0)
+        return false;
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->key == key)
+        {
+            //the entry becomes the most recently used. The vectors keep their
+            //capacity, so copying does not allocate memory once they are big enough
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            for (int i = 0; i < k_layer_max; ++i)
+            {
+                pLayers[i].rects = it->layers[i];
+                pLayers[i].fDirty = false;
+            }
+            *pShape = it->shape;
+            ++m_hits;
+            return true;
+        }
+    }
+
+    ++m_misses;
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+void ShapeCache::add(const ShapeKey& key, const RenderLayer* pLayers,
+                     const ShapeBuilder& shape)
+{
+    if (m_budget == 0)
+        return;
+
+    //replace a previous entry for the same key, if any
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->key == key)
+        {
+            m_bytes -= it->bytes;
+            m_entries.erase(it);
+            break;
+        }
+    }
+
+    m_entries.emplace_front();
+    Entry& entry = m_entries.front();
+    entry.key = key;
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        entry.layers[i] = pLayers[i].rects;
+    }
+    entry.shape = shape;
+    entry.bytes = compute_bytes(entry);
+    m_bytes += entry.bytes;
+
+    //an entry bigger than the budget is not kept
+    trim(m_budget);
+}
+
+//---------------------------------------------------------------------------------------
+size_t ShapeCache::compute_bytes(const Entry& entry)
+{
+    //the shape rectangles are counted twice, as an estimation of the region size
+    size_t bytes = sizeof(Entry);
+    for (int i = 0; i < k_layer_max; ++i)
+    {
+        bytes += entry.layers[i].capacity() * sizeof(FilledRect);
+    }
+    bytes += 2 * entry.shape.get_rects().capacity() * sizeof(wxRect);
+    return bytes;
+}
+
+//---------------------------------------------------------------------------------------
+void ShapeCache::trim(size_t budget)
+{
+    while (m_bytes > budget && !m_entries.empty())
+    {
+        m_bytes -= m_entries.back().bytes;
+        m_entries.pop_back();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+wxString ShapeCache::get_report() const
+{
+    return wxString::Format("shape_cache hits=%lu misses=%lu entries=%lu kb=%lu",
+                            m_hits, m_misses, (unsigned long)m_entries.size(),
+                            (unsigned long)((m_bytes + 1023) / 1024));
+}
+
+
+} // namespace agrilla
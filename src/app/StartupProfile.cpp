@@ -0,0 +1,65 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "StartupProfile.h"
+
+
+namespace agrilla
+{
+
+//the program start. Static variables are initialized before main() is invoked
+static const std::chrono::steady_clock::time_point k_program_start =
+    std::chrono::steady_clock::now();
+
+//---------------------------------------------------------------------------------------
+StartupProfile::StartupProfile()
+    : m_start(k_program_start)
+    , m_last(k_program_start)
+{
+    m_phases.reserve(16);
+}
+
+//---------------------------------------------------------------------------------------
+void StartupProfile::mark(const char* phase)
+{
+    if (m_fFinished)
+        return;
+
+    Clock::time_point now = Clock::now();
+    double ms = std::chrono::duration<double, std::milli>(now - m_last).count();
+    m_phases.push_back(std::make_pair(phase, ms));
+    m_last = now;
+}
+
+//---------------------------------------------------------------------------------------
+void StartupProfile::finish(const char* phase)
+{
+    mark(phase);
+    m_fFinished = true;
+}
+
+//---------------------------------------------------------------------------------------
+wxString StartupProfile::get_report() const
+{
+    double total = std::chrono::duration<double, std::milli>(m_last - m_start).count();
+    wxString report = wxString::Format("startup_ms total=%.2f", total);
+    for (const auto& phase : m_phases)
+        report += wxString::Format(" %s=%.2f", phase.first, phase.second);
+    return report;
+}
+
+
+} // namespace agrilla
@@ -13,17 +13,26 @@
 #include <wx/stdpaths.h> // For finding standard directories
 #include <wx/file.h>     // For creating and writing to a file
 #include <wx/filename.h> // For path manipulation
-#include <wx/fileconf.h>
+#include <wx/cmdline.h>
+#if defined(AGRILLA_BENCHMARK)
+    #include <wx/memconf.h>
+#endif
 
 //agrilla
 #include "TheApp.h"
+#include "BackendComparison.h"
 #include "MainFrame.h"
+#include "Preferences.h"
+#include "RingBufferLog.h"
+#include "Tracer.h"
 #include "config.h"
 #include "version.h"
 
 //other
 #include <fstream>
 
+//log messages from this file belong to the 'agrilla/app' module
+#define wxLOG_COMPONENT "agrilla/app"
 
 
 //implement function wxGetApp() that returns a reference to TheApp instance
@@ -38,19 +47,180 @@ namespace agrilla
 bool TheApp::OnInit()
 {
     // 'Main program' equivalent: the program execution "starts" here
+    m_startup.mark("wx_init");
+
+    //parse the command line options. The benchmark is run from OnRun()
+    if (!wxApp::OnInit())
+        return false;
+    m_startup.mark("cmd_line");
 
     create_log_file();
+    m_startup.mark("log");
     create_preferences_file();
+    m_startup.mark("prefs");
+    configure_log_levels();
+    m_startup.mark("log_levels");
+
+    //tracing can also be enabled from the environment
+    if (m_traceFile.IsEmpty())
+        wxGetEnv("AGRILLA_TRACE", &m_traceFile);
+    if (!m_traceFile.IsEmpty())
+        Tracer::start(m_traceFile);
 
+#if !defined(AGRILLA_BENCHMARK)
     MainFrame* mainFrame = new MainFrame();
     mainFrame->Show(true);
+    m_startup.mark("show");
+
+    if (!m_recordFile.IsEmpty())
+        m_inputRecorder.start(m_recordFile, mainFrame->GetRect());
+    if (!m_replayFile.IsEmpty())
+        CallAfter([this, mainFrame]() { replay_input(mainFrame); });
+    if (m_fCompareBackends)
+        CallAfter([this, mainFrame]() { compare_backends(mainFrame); });
+#endif
 
     return true;    //to indicate that the application should continue running
 }
 
+#if defined(AGRILLA_BENCHMARK)
+//---------------------------------------------------------------------------------------
+int TheApp::OnRun()
+{
+    MainFrame* pFrame = new MainFrame();
+    pFrame->Show(true);
+    Yield(true);
+
+    Benchmark benchmark(pFrame, m_benchOptions);
+    int exitCode = benchmark.run();
+
+    pFrame->Destroy();
+    return exitCode;
+}
+
+#endif
+
+//---------------------------------------------------------------------------------------
+void TheApp::OnInitCmdLine(wxCmdLineParser& parser)
+{
+    wxApp::OnInitCmdLine(parser);
+    parser.AddLongSwitch("startup-report", "print the startup times and exit");
+    parser.AddLongOption("trace", "write a trace of events and drawing to this file");
+    parser.AddLongOption("record", "record the mouse and tool events to this file");
+    parser.AddLongOption("replay", "replay the events in this file, report the times and exit");
+    parser.AddLongOption("replay-speed", "'original' (default) or 'max'");
+    parser.AddLongOption("paint-backend", "'gc' (default), 'dc' or 'raster'");
+    parser.AddLongSwitch("compare-backends", "compare the paint backends, report and exit");
+
+#if defined(AGRILLA_BENCHMARK)
+    parser.AddLongOption("repeat", "times each stage is measured (default 5)",
+                         wxCMD_LINE_VAL_NUMBER);
+    parser.AddLongSwitch("quick", "measure only a few sizes and grid options");
+    parser.AddLongOption("output", "file for the JSON results (default stdout)");
+    parser.AddLongOption("baseline", "compare with the results in this file");
+    parser.AddLongOption("save-baseline", "save the results as baseline in this file");
+    parser.AddLongOption("threshold", "slowdown to report a regression (default 0.20)",
+                         wxCMD_LINE_VAL_DOUBLE);
+#endif
+}
+
+//---------------------------------------------------------------------------------------
+bool TheApp::OnCmdLineParsed(wxCmdLineParser& parser)
+{
+    m_fStartupReport = parser.Found("startup-report");
+    parser.Found("trace", &m_traceFile);
+    parser.Found("record", &m_recordFile);
+    parser.Found("replay", &m_replayFile);
+    wxString speed;
+    if (parser.Found("replay-speed", &speed))
+        m_fReplayMaxSpeed = (speed == "max");
+    parser.Found("paint-backend", &m_paintBackend);
+    m_fCompareBackends = parser.Found("compare-backends");
+
+#if defined(AGRILLA_BENCHMARK)
+    long repeat;
+    if (parser.Found("repeat", &repeat))
+        m_benchOptions.repeat = static_cast<int>(repeat);
+    m_benchOptions.fQuick = parser.Found("quick");
+    parser.Found("output", &m_benchOptions.outputFile);
+    parser.Found("baseline", &m_benchOptions.baselineFile);
+    parser.Found("save-baseline", &m_benchOptions.saveBaselineFile);
+    parser.Found("threshold", &m_benchOptions.threshold);
+#endif
+
+    return wxApp::OnCmdLineParsed(parser);
+}
+
+//---------------------------------------------------------------------------------------
+void TheApp::on_first_paint()
+{
+    //The startup ends when the main frame has been painted for the first time
+    if (m_startup.is_finished())
+        return;
+
+    m_startup.finish("first_paint");
+    wxString report = m_startup.get_report();
+    wxLogMessage("[TheApp::on_first_paint] %s", report);
+
+    if (m_fStartupReport)
+    {
+        wxPrintf("%s\n", report);
+        fflush(stdout);
+        CallAfter([this]() { GetTopWindow()->Close(true); });
+    }
+}
+
+
+//---------------------------------------------------------------------------------------
+void TheApp::replay_input(MainFrame* pFrame)
+{
+    //Sends the recorded events to the main frame, prints the report and exits
+    InputReplay replay(pFrame, m_fReplayMaxSpeed);
+    if (replay.load(m_replayFile))
+    {
+        wxString report = replay.run();
+        wxLogMessage("[TheApp::replay_input] %s", report);
+        wxPrintf("%s\n", report);
+        fflush(stdout);
+    }
+    pFrame->Close(true);
+}
+
+//---------------------------------------------------------------------------------------
+void TheApp::compare_backends(MainFrame* pFrame)
+{
+    //Paints the same states with each paint backend, prints the report and exits
+    BackendComparison comparison(pFrame->get_layer_colours());
+    wxString report = comparison.run();
+    wxLogMessage("[TheApp::compare_backends] %s", report);
+    wxPrintf("%s\n", report);
+    fflush(stdout);
+    pFrame->Close(true);
+}
+
+//---------------------------------------------------------------------------------------
+wxString TheApp::get_paint_backend()
+{
+    //The command line option has precedence over preference '/Render/PaintBackend'
+    if (!m_paintBackend.IsEmpty())
+        return m_paintBackend;
+
+    wxString name = "gc";
+    if (m_pPrefs)
+        m_pPrefs->Read("/Render/PaintBackend", &name);
+    return name;
+}
+
 //---------------------------------------------------------------------------------------
 int TheApp::OnExit()
 {
+    Tracer::stop();
+    m_inputRecorder.stop();
+
+    //write pending log messages before closing the file
+    if (m_pRingLog)
+        m_pRingLog->stop();
+
     if (m_logFilePtr != nullptr)
     {
         fclose(m_logFilePtr);
@@ -58,8 +228,10 @@ int TheApp::OnExit()
 
     delete m_pLogWindow;
 
-    m_pPrefs->Flush();
-//    delete m_pPrefs;      //causes double delete !!  Why?
+    //wait for pending preferences to be written. The wxConfigBase object is deleted
+    //by wxWidgets, after OnExit()
+    delete m_pPreferences;
+    m_pPreferences = nullptr;
 
     return wxApp::OnExit();
 }
@@ -67,15 +239,27 @@ int TheApp::OnExit()
 //---------------------------------------------------------------------------------------
 void TheApp::create_preferences_file()
 {
+#if defined(AGRILLA_BENCHMARK)
+    //the benchmark must not use nor modify the user preferences. And it measures
+    //the shaped window, even if the ARGB overlay mode is supported
+    wxConfigBase::Set(new wxMemoryConfig());
+    m_pPrefs = wxConfigBase::Get();
+    m_pPrefs->Write("/Render/OverlayMode", "shaped");
+
+#else
     wxString configPath = ensure_config_folder_exists("agrilla.ini");
     wxLogMessage("[TheApp::create_preferences_file] configPath '%s'", configPath);
-    wxFileConfig* pConfig = new wxFileConfig("agrilla", "agrilla", configPath,
-                                             "agrilla", wxCONFIG_USE_LOCAL_FILE );
+    m_pPreferences = new Preferences(configPath);
+    m_pPrefs = m_pPreferences->get_config();
+#endif
+}
 
-    wxConfigBase::Set(pConfig);
-    pConfig->SetRecordDefaults();
-    pConfig->Flush();
-    m_pPrefs = wxConfigBase::Get();
+//---------------------------------------------------------------------------------------
+void TheApp::save_preferences()
+{
+    //the file is written in background. It does not block the GUI
+    if (m_pPreferences)
+        m_pPreferences->save();
 }
 
 //---------------------------------------------------------------------------------------
@@ -87,7 +271,12 @@ void TheApp::create_log_file()
 //    #endif
 
 
-#if defined(DEBUG) && defined(__WXGTK__)
+#if defined(AGRILLA_BENCHMARK)
+
+    //the benchmark writes its results to stdout. Log messages go to stderr
+    wxLog::SetActiveTarget(new wxLogStderr());
+
+#elif defined(DEBUG) && defined(__WXGTK__)
 
     //in local Debug build in Linux with with Code::Blocks, use a window to show wxLog
     //messages. This is the only way I've found to see wxLog messages in real time
@@ -111,10 +300,12 @@ void TheApp::create_log_file()
     // Check if the file was opened successfully.
     if (m_logFilePtr != nullptr)
     {
-        // If successful, create a wxLogStderr object using the file pointer.
+        // If successful, create a RingBufferLog object using the file pointer. Messages
+        // are written to the file by a background thread, not to block the GUI.
         // wxLog::SetActiveTarget() takes ownership of the pointer to the log target.
         // This will redirect all wxLog messages to our file.
-        wxLog::SetActiveTarget(new wxLogStderr(m_logFilePtr));
+        m_pRingLog = new RingBufferLog(m_logFilePtr);
+        wxLog::SetActiveTarget(m_pRingLog);
         wxLogMessage("[TheApp::create_log_file] Application started successfully.");
     }
     else
@@ -134,133 +325,36 @@ void TheApp::create_log_file()
 }
 
 //---------------------------------------------------------------------------------------
-wxString TheApp::get_resources_path()
+void TheApp::configure_log_levels()
 {
-    // Obtaining the resources file with the icons depends on how the progam is build and
-    // were is it running from.
-    //
-    // a) When building without CMake, variable AGRILLA_RES_INSTALL_DIR is not
-    //    defined. Then there are two cases:
-    //    a.1) The running executable is under the 'agrilla/<branchname>/' tree. The
-    //         resources folder can be determined from the executable dir.
-    //    a.2) The running executable does not contain the 'agrilla' folder. It is a
-    //         local build out of the source tree without using CMake, or an installed
-    //         build without using CMake
-    //
-    // b) For CMake builds there are two cases:
-    //    b.1) The new build is not installed, the program is running from the build
-    //         directory. Then, AGRILLA_RES_INSTALL_DIR is defined but it is not valid
-    //         because it could not exist (not yet created) or, if exists, it contains
-    //         the icons for a previous installation.
-    //    b.2) The new buils is installed and the program is run from the installation
-    //         folder. In this case AGRILLA_RES_INSTALL_DIR is defined and is valid
-
-#ifndef AGRILLA_RES_INSTALL_DIR
-    // a.1) For local builds not using CMake, variable AGRILLA_RES_INSTALL_DIR is not
-    // defined. To determine the resources directory we assume that any locally built
-    // executable will run from a build subdirectory under the 'agrilla/<branchname>/'
-    // source tree, like  agrilla/main/my-build/". So the approach is to check the
-    // location of the running executable, and to remove all subdirs to leave only
-    // the path to 'agrilla/<branchname>/', and to append 'res' to it.
-
-    wxString path = get_resources_path_from_executable();
-    if (path != wxEmptyString)
-    {
-        //a.1) local build without CMake under the 'agrilla' folder
-        wxLogMessage("[TheApp::get_resources_path] Case a.1) local build without CMake under the 'agrilla' folder.\n"
-                     "                   Resources path='%s'", path);
-        return path;
-    }
-    else
-    {
-        // a.2) Macro AGRILLA_RES_INSTALL_DIRThe 'agrilla' is not defined and 'agrilla'
-        // folder is not in the executable path. The most likely cause is that
-        // it is an installed executable running from the standard system binary
-        // directory like /usr/bin/ on Linux, but installed without building with CMake.
-        // Alternativelly, it is a local build out of the source tree. In this las case
-        // it is impossible to determine the resources path. So let's assume that is
-        // an installed executable and that it is properly installed.
-        path = wxStandardPaths::Get().GetDataDir();
-        wxLogMessage("[TheApp::get_resources_path] Case a.2) Out-of-source builds or installed without CMake.\n"
-                     "                   Resources path='%s'", path);
-        return path;
-    }
+    //By default, debug messages are not logged. Levels for each module can be
+    //changed with preference '/Log/Levels' and with environment variable AGRILLA_LOG.
+    //Both are a list such as "frame=debug,prefs=warning". See RingBufferLog::set_levels()
 
-#else
-    // AGRILLA_RES_INSTALL_DIR exists. It is a build done with CMake but we don't know
-    // if it is a locally build executable or an installed executable. Let's assume
-    // that any locally build executable runs from a subfolder of the 'agrilla'
-    // source tree.
+    wxLog::SetComponentLevel("agrilla", wxLOG_Info);
 
-    wxString path = get_resources_path_from_executable();
-    if (path != wxEmptyString)
-    {
-        //b.1) local build with CMake under the 'agrilla' folder
-         wxLogMessage("[TheApp::get_resources_path] Case b.1) local build with CMake under the 'agrilla' folder.\n"
-                      "                   Resources path='%s'", path);
-        return path;
-    }
-    else
-    {
-        //b.2) installed build using CMake. AGRILLA_RES_INSTALL_DIR is valid
-        wxFileName fName(AGRILLA_RES_INSTALL_DIR);
-        fName.Normalize(wxPATH_NORM_DOTS);
-        path = fName.GetFullPath();
-        wxLogMessage("[TheApp::get_resources_path] Case b.2) installed build using CMake.\n"
-                     "                   Resources path='%s'", path);
-        return path;
-    }
-#endif
+    wxString spec;
+    if (m_pPrefs && m_pPrefs->Read("/Log/Levels", &spec) && !spec.IsEmpty())
+        RingBufferLog::set_levels(spec);
 
+    if (wxGetEnv("AGRILLA_LOG", &spec) && !spec.IsEmpty())
+        RingBufferLog::set_levels(spec);
 }
 
 //---------------------------------------------------------------------------------------
-wxString TheApp::get_resources_path_from_executable()
+wxString TheApp::get_icons_dir()
 {
-    // To determine the resources directory we assume that any locally built
-    // executable will run from a build subdirectory under the 'agrilla/<branchname>/'
-    // source tree, like  agrilla/main/my-build/". So the approach is to check the
-    // location of the running executable, and to remove all subdirs to leave only
-    // the path to 'agrilla/<branchname>/', and to append 'res' to it.
-
-    wxFileName fName(wxStandardPaths::Get().GetExecutablePath());
+    //The toolbar icons are compiled into the executable. For theming, they can be
+    //replaced by the icons in the folder set in environment variable AGRILLA_ICONS_DIR
+    //or in preference '/Toolbar/IconsDir'. Returns an empty string when not set.
 
-    wxString branchDir;
-    bool fFoundAgrillaDir = false;
+    wxString dir;
+    if (wxGetEnv("AGRILLA_ICONS_DIR", &dir) && !dir.IsEmpty())
+        return dir;
 
-    // Store the last directory as we loop
-    while (!fName.GetDirs().empty())
-    {
-        wxString lastDir = fName.GetDirs().Last();
-        if (lastDir == "agrilla")
-        {
-            fFoundAgrillaDir = true;
-            break;
-        }
-
-        // This will only store the immediate child of 'agrilla'
-        branchDir = lastDir;
-        fName.RemoveLastDir();
-    }
-
-    if (fFoundAgrillaDir)
-    {
-        // Re-append the branch directory if it exists
-        if (!branchDir.IsEmpty())
-        {
-            fName.AppendDir(branchDir);
-        }
-        fName.AppendDir("res");
-        return fName.GetPath(wxPATH_GET_SEPARATOR);
-    }
-    else
-    {
-        // The 'agrilla' folder is not in the executable path. It is either an installed
-        // executable is placed in a standard system binary directory like /usr/bin/ on
-        // Linux, or it is a local build out of the source tree. In any case the
-        // resources path cannot be determined from the execution path
-        return wxEmptyString;
-    }
+    if (m_pPrefs)
+        m_pPrefs->Read("/Toolbar/IconsDir", &dir);
+    return dir;
 }
 
 //---------------------------------------------------------------------------------------
@@ -9,9 +9,13 @@
 
 #include "ToolBar.h"
 #include "MainFrame.h"
+#include "Tracer.h"
 #include <wx/tooltip.h> // For tooltips
 #include <wx/dcclient.h> // Required for wxPaintDC
 #include <wx/brush.h>    // Required for wxBrush
+#include <wx/font.h>
+
+#include <algorithm>
 
 
 namespace agrilla
@@ -19,94 +23,139 @@ namespace agrilla
 
 //---------------------------------------------------------------------------------------
 ToolBar::ToolBar(MainFrame* parent, wxWindowID id, int width, const wxSize& iconsSize,
-                 const wxColour bgColour)
+                 const wxColour bgColour, const wxString& iconsDir)
     : wxPanel(parent, id, wxPoint(0,0), wxSize(width, 53), wxTAB_TRAVERSAL,
               wxPanelNameStr)
+    , m_pFrame(parent)
     , m_iconSize(iconsSize)
     , m_bgColour(bgColour)
     , m_nextButtonX(0)
     , m_buttonPadding(3)
+    , m_iconLoader(this, iconsSize, iconsDir)
 {
+    //all the toolbar is painted in on_paint()
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+
     //Tric to deal with the mouse. As MainFrame is a shaped frame, the mouse needs
-    //to be captured and managed by MainFrame. Thus, mouse events are first
-    //processed by MainFrame and, then, if not valid there, will be skipped to
-    //arrive to the toolbar controls. Without this hack, mouse events are processed
-    //by ToolBal and never arrive to MainFrame.
-    Bind(wxEVT_MOTION, &MainFrame::on_mouse_motion, parent);
-    Bind(wxEVT_LEFT_DOWN, &MainFrame::on_mouse_left_down, parent);
-    Bind(wxEVT_LEFT_UP, &MainFrame::on_mouse_left_up, parent);
+    //to be captured and managed by MainFrame. Thus, mouse events not used by the
+    //toolbar tools are passed to MainFrame. Without this hack, mouse events are
+    //processed by ToolBal and never arrive to MainFrame.
+    Bind(wxEVT_MOTION, &ToolBar::on_mouse_motion, this);
+    Bind(wxEVT_LEFT_DOWN, &ToolBar::on_mouse_left_down, this);
+    Bind(wxEVT_LEFT_UP, &ToolBar::on_mouse_left_up, this);
+    Bind(wxEVT_LEAVE_WINDOW, &ToolBar::on_mouse_leave, this);
+    Bind(wxEVT_LEFT_DCLICK, &MainFrame::on_mouse_left_dclick, parent);
+
+    Bind(wxEVT_PAINT, &ToolBar::on_paint, this);
+    Bind(wxEVT_THREAD, &ToolBar::on_icon_loaded, this);
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::add_tool(wxWindowID id, const wxString& icon, const wxString& tooltip)
+{
+    add_tool_record({ id, icon, wxEmptyString, wxBitmapBundle(), wxBitmapBundle(), false,
+                      tooltip, wxEmptyString, false, false, wxRect() });
 }
 
 //---------------------------------------------------------------------------------------
-void ToolBar::add_tool(wxWindowID id, const wxBitmapBundle& bitmap,
-                       const wxString& tooltip)
+void ToolBar::add_check_tool(wxWindowID id, const wxString& normalIcon,
+                             const wxString& checkedIcon,
+                             const wxString& normalTooltip, const wxString& checkedTooltip)
+{
+    add_tool_record({ id, normalIcon, checkedIcon, wxBitmapBundle(), wxBitmapBundle(),
+                      false, normalTooltip, checkedTooltip, true, false, wxRect() });
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::add_tool_record(const ToolRecord& tool)
 {
     // Calculate button size including internal padding to make it square around the icon
     wxSize buttonSize(m_iconSize.GetWidth() + m_buttonPadding * 2, m_iconSize.GetHeight() + m_buttonPadding * 2);
 
-    wxBitmapButton* button = new wxBitmapButton(this, id, bitmap,
-                                                wxPoint(m_nextButtonX + m_buttonPadding, m_buttonPadding),
-                                                buttonSize, wxBORDER_NONE);
-    button->SetToolTip(tooltip);
-    button->SetLabel(wxEmptyString);
-    button->SetBackgroundColour(*m_bgColour);
-    button->Bind(wxEVT_BUTTON, &ToolBar::on_button_click, this);
-
-    m_buttons.push_back(button);
-    m_buttonMap[id] = button;
-    m_toolNormalBitmaps[id] = bitmap;
-    m_toolStates[id] = false; // Not a check tool, so state is always false
+    m_tools.push_back(tool);
+    m_tools.back().rect = wxRect(wxPoint(m_nextButtonX + m_buttonPadding, m_buttonPadding),
+                                 buttonSize);
 
     // Update position for the next button
     m_nextButtonX += (buttonSize.GetWidth() + m_buttonPadding);
+
+    int index = static_cast<int>(m_tools.size()) - 1;
+    request_icon(index, false);
+    refresh_tool(index);
 }
 
 //---------------------------------------------------------------------------------------
-void ToolBar::add_check_tool(wxWindowID id, const wxBitmapBundle& normalBitmap,
-                             const wxBitmapBundle& checkedBitmap,
-                             const wxString& normalTooltip, const wxString& checkedTooltip)
+void ToolBar::request_icon(int index, bool fChecked)
 {
-    wxSize buttonSize(m_iconSize.GetWidth() + m_buttonPadding * 2, m_iconSize.GetHeight() + m_buttonPadding * 2);
+    ToolRecord& tool = m_tools[index];
+    if (fChecked)
+    {
+        if (tool.fCheckedRequested || tool.checkedIcon.IsEmpty())
+            return;
+        tool.fCheckedRequested = true;
+    }
+    m_iconLoader.request(tool.id, fChecked ? 1 : 0,
+                         fChecked ? tool.checkedIcon : tool.normalIcon);
+}
 
-    wxBitmapButton* button = new wxBitmapButton(this, id, normalBitmap,
-                                                wxPoint(m_nextButtonX + m_buttonPadding, m_buttonPadding),
-                                                buttonSize, wxBORDER_NONE);
-    button->SetToolTip(normalTooltip);
-    button->SetLabel(wxEmptyString);
-    button->SetBackgroundColour(*m_bgColour);
-    button->Bind(wxEVT_BUTTON, &ToolBar::on_button_click, this);
-
-    m_buttons.push_back(button);
-    m_buttonMap[id] = button;
-    m_toolNormalBitmaps[id] = normalBitmap;
-    m_toolCheckedBitmaps[id] = checkedBitmap;
-    m_toolNormalTooltips[id] = normalTooltip;
-    m_toolCheckedTooltips[id] = checkedTooltip;
-    m_toolStates[id] = false; // Initial state is unchecked
+//---------------------------------------------------------------------------------------
+void ToolBar::on_icon_loaded(wxThreadEvent& event)
+{
+    int index = find_tool(event.GetId());
+    if (index < 0)
+        return;
 
-    m_nextButtonX += (buttonSize.GetWidth() + m_buttonPadding);
+    ToolRecord& tool = m_tools[index];
+    if (event.GetInt() == 1)
+        tool.checkedBitmap = event.GetPayload<wxBitmapBundle>();
+    else
+        tool.normalBitmap = event.GetPayload<wxBitmapBundle>();
+    refresh_tool(index);
 }
 
 //---------------------------------------------------------------------------------------
-void ToolBar::set_tool_checked(wxWindowID id, bool checked)
+int ToolBar::find_tool(wxWindowID id) const
 {
-    auto it = m_buttonMap.find(id);
-    if (it != m_buttonMap.end())
+    for (size_t i = 0; i < m_tools.size(); ++i)
     {
-        wxBitmapButton* button = it->second;
-        m_toolStates[id] = checked; // Update the internal state
-        if (checked && m_toolCheckedBitmaps.count(id))
-        {
-            button->SetBitmapLabel(m_toolCheckedBitmaps[id]);
-            button->SetToolTip(m_toolCheckedTooltips[id]);
-        }
-        else if (m_toolNormalBitmaps.count(id))
-        {
-            button->SetBitmapLabel(m_toolNormalBitmaps[id]);
-            button->SetToolTip(m_toolNormalTooltips[id]);
-        }
-        button->Refresh(); // Redraw the button to show the new bitmap
+        if (m_tools[i].id == id)
+            return static_cast<int>(i);
     }
+    return -1;
+}
+
+//---------------------------------------------------------------------------------------
+int ToolBar::hit_test(const wxPoint& pos) const
+{
+    for (size_t i = 0; i < m_tools.size(); ++i)
+    {
+        if (m_tools[i].rect.Contains(pos))
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::refresh_tool(int index)
+{
+    if (index >= 0)
+        RefreshRect(m_tools[index].rect);
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::set_tool_checked(wxWindowID id, bool checked)
+{
+    int index = find_tool(id);
+    if (index < 0)
+        return;
+
+    ToolRecord& tool = m_tools[index];
+    tool.fChecked = tool.fCheckTool && checked;   //not a check tool: always false
+    if (tool.fChecked)
+        request_icon(index, true);      //first time checked: create the checked icon
+    if (index == m_hoverTool)
+        SetToolTip(tool.fChecked ? tool.checkedTooltip : tool.normalTooltip);
+    refresh_tool(index);    // Redraw the button to show the new bitmap
 }
 
 //---------------------------------------------------------------------------------------
@@ -121,22 +170,172 @@ wxRect ToolBar::get_move_handle() const
 //---------------------------------------------------------------------------------------
 bool ToolBar::is_tool_checked(wxWindowID id) const
 {
-    auto it = m_toolStates.find(id);
-    if (it != m_toolStates.end())
+    int index = find_tool(id);
+    return (index >= 0 ? m_tools[index].fChecked : false);
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::change_colour(const wxColour bgColour)
+{
+    m_bgColour = bgColour;
+    Refresh();
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::set_hud_text(const wxString& text)
+{
+    m_hudText = text;
+    RefreshRect(get_hud_rect());
+}
+
+//---------------------------------------------------------------------------------------
+wxRect ToolBar::get_hud_rect() const
+{
+    //the area after last button
+    int left = m_nextButtonX + m_buttonPadding;
+    return wxRect(left, 0, std::max(GetSize().GetWidth() - left, 0), GetSize().GetHeight());
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::on_paint(wxPaintEvent& WXUNUSED(event))
+{
+    TRACE_SCOPE("ToolBar::on_paint");
+    wxPaintDC dc(this);
+
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    dc.SetBrush(wxBrush(m_bgColour));
+    dc.DrawRectangle(GetClientRect());
+
+    //tools. The tool under the mouse is highlighted, and darker while pressed
+    for (size_t i = 0; i < m_tools.size(); ++i)
+    {
+        const ToolRecord& tool = m_tools[i];
+        int index = static_cast<int>(i);
+        if (index == m_hoverTool)
+        {
+            int lightness = (index == m_pressedTool ? 85 : 115);
+            dc.SetBrush(wxBrush(m_bgColour.ChangeLightness(lightness)));
+            dc.DrawRectangle(tool.rect);
+        }
+
+        //the icon, or an empty slot while it is being created
+        const wxBitmapBundle& bundle = (tool.fChecked ? tool.checkedBitmap
+                                                      : tool.normalBitmap);
+        wxBitmap bitmap = (bundle.IsOk() ? bundle.GetBitmapFor(this) : wxBitmap());
+        if (bitmap.IsOk())
+        {
+            wxSize size = bitmap.GetLogicalSize();
+            dc.DrawBitmap(bitmap, tool.rect.x + (tool.rect.width - size.GetWidth()) / 2,
+                          tool.rect.y + (tool.rect.height - size.GetHeight()) / 2, true);
+        }
+        else
+        {
+            dc.SetBrush(*wxTRANSPARENT_BRUSH);
+            dc.SetPen(wxPen(m_bgColour.ChangeLightness(130)));
+            dc.DrawRoundedRectangle(wxRect(tool.rect).Deflate(m_buttonPadding), 3);
+            dc.SetPen(*wxTRANSPARENT_PEN);
+        }
+    }
+
+    //diagnostics HUD, if enabled
+    if (!m_hudText.IsEmpty())
     {
-        return it->second;
+        dc.SetFont(wxFont(wxFontInfo(7).Family(wxFONTFAMILY_TELETYPE)));
+        dc.SetTextForeground(*wxWHITE);
+        dc.DrawLabel(m_hudText, wxRect(get_hud_rect()).Deflate(m_buttonPadding),
+                     wxALIGN_LEFT | wxALIGN_CENTER_VERTICAL);
     }
-    return false; // Default for non-check tools or unknown ID
 }
 
 //---------------------------------------------------------------------------------------
-void ToolBar::change_colour(const wxColour bgColour)
+void ToolBar::set_hover_tool(int index)
 {
-    for (auto it = m_buttonMap.begin(); it != m_buttonMap.end(); ++it)
+    if (index == m_hoverTool)
+        return;
+
+    refresh_tool(m_hoverTool);
+    m_hoverTool = index;
+    refresh_tool(m_hoverTool);
+
+    if (index >= 0)
     {
-        wxBitmapButton* button = it->second;
-        button->SetBackgroundColour(bgColour);
+        const ToolRecord& tool = m_tools[index];
+        SetToolTip(tool.fChecked ? tool.checkedTooltip : tool.normalTooltip);
     }
+    else
+        UnsetToolTip();
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::on_mouse_motion(wxMouseEvent& event)
+{
+    //while a tool is pressed, it is only highlighted when the mouse is over it
+    int index = hit_test(event.GetPosition());
+    if (m_pressedTool < 0 || index == m_pressedTool || index < 0)
+        set_hover_tool(index);
+
+    m_pFrame->on_mouse_motion(event);
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::on_mouse_leave(wxMouseEvent& event)
+{
+    set_hover_tool(-1);
+    event.Skip();
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::on_mouse_left_down(wxMouseEvent& event)
+{
+    int index = hit_test(event.GetPosition());
+    if (index < 0)
+    {
+        //not on a tool: it could be the move handle
+        m_pFrame->on_mouse_left_down(event);
+        return;
+    }
+
+    m_pressedTool = index;
+    set_hover_tool(index);
+    refresh_tool(index);
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::on_mouse_left_up(wxMouseEvent& event)
+{
+    //MainFrame must finish any drag before the tool action, that could open a dialog
+    m_pFrame->on_mouse_left_up(event);
+
+    int pressed = m_pressedTool;
+    m_pressedTool = -1;
+    if (pressed >= 0)
+    {
+        refresh_tool(pressed);
+        if (hit_test(event.GetPosition()) == pressed)
+            click_tool(pressed);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ToolBar::click_tool(int index)
+{
+    TRACE_SCOPE("ToolBar::click_tool");
+    ToolRecord& tool = m_tools[index];
+    wxCommandEvent event(wxEVT_BUTTON, tool.id);
+    event.SetEventObject(this);
+
+    // If it's a check tool, toggle its state and set the 'checked' state in the
+    // event object for the parent
+    if (tool.fCheckTool)
+    {
+        set_tool_checked(tool.id, !tool.fChecked);
+        event.SetInt(tool.fChecked ? 1 : 0);
+    }
+
+    // Send the event to the parent (MainFrame). It will receive a wxEVT_BUTTON event
+    // for the tool's ID. It can then query the toolbar's is_tool_checked(id) if it
+    // needs the state.
+    GetParent()->GetEventHandler()->ProcessEvent(event);
 }
 
 //---------------------------------------------------------------------------------------
@@ -151,7 +350,7 @@ wxSize ToolBar::get_size() const
     int width = m_nextButtonX + m_buttonPadding; // Add padding for the right edge of the toolbar
 
     // Ensure a minimum height if no buttons are added yet
-    if (m_buttons.empty())
+    if (m_tools.empty())
     {
         height = m_iconSize.GetHeight() + m_buttonPadding * 4; // A default height
         width = 0;
@@ -160,22 +359,4 @@ wxSize ToolBar::get_size() const
     return wxSize(width, height);
 }
 
-//---------------------------------------------------------------------------------------
-void ToolBar::on_button_click(wxCommandEvent& event)
-{
-    wxWindowID id = event.GetId();
-    // If it's a check tool, toggle its state internally and update its bitmap
-    if (m_toolCheckedBitmaps.count(id))
-    {
-        bool newCheckedState = !m_toolStates[id];
-        set_tool_checked(id, newCheckedState);
-        // For check tools, set the 'checked' state in the event object for the parent
-        event.SetInt(newCheckedState ? 1 : 0);
-    }
-    // Propagate the event up to the parent (MainFrame)
-    // The MainFrame will receive a wxEVT_BUTTON event for the tool's ID.
-    // It can then query the toolbar's is_tool_checked(id) if it needs the state.
-    GetParent()->GetEventHandler()->ProcessEvent(event);
-}
-
 } // namespace agrilla
@@ -0,0 +1,153 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//agrilla
+#include "Tracer.h"
+
+//std
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+
+//log messages from this file belong to the 'agrilla/trace' module
+#define wxLOG_COMPONENT "agrilla/trace"
+
+
+namespace agrilla
+{
+
+const size_t MAX_TRACE_EVENTS = 1000000;    //about 24 MB. Later events are dropped
+
+std::atomic<bool> Tracer::m_fEnabled(false);
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        long long begin;        //microseconds since the tracer start
+        long long duration;     //microseconds
+        int thread;
+    };
+
+    struct TraceData
+    {
+        std::mutex mutex;
+        wxString filename;
+        Tracer::Clock::time_point start;
+        std::vector<TraceEvent> events;
+        size_t dropped = 0;
+        int mainThread = 0;
+    };
+
+    TraceData& get_data()
+    {
+        static TraceData data;
+        return data;
+    }
+
+    //small sequential numbers are easier to read in the viewer than the system ids
+    int get_thread_number()
+    {
+        static std::atomic<int> s_next(1);
+        thread_local int number = s_next.fetch_add(1);
+        return number;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+bool Tracer::start(const wxString& filename)
+{
+    TraceData& data = get_data();
+    {
+        std::lock_guard<std::mutex> lock(data.mutex);
+        if (m_fEnabled)
+            return false;
+
+        data.filename = filename;
+        data.start = Clock::now();
+        data.events.clear();
+        data.events.reserve(64 * 1024);
+        data.dropped = 0;
+        data.mainThread = get_thread_number();
+    }
+    m_fEnabled = true;
+
+    wxLogMessage("[Tracer::start] Tracing to file '%s'", filename);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void Tracer::add_event(const char* name, Clock::time_point begin, Clock::time_point end)
+{
+    TraceData& data = get_data();
+    int thread = get_thread_number();
+
+    std::lock_guard<std::mutex> lock(data.mutex);
+    if (!m_fEnabled)
+        return;     //stopped while the scope was running
+
+    if (data.events.size() >= MAX_TRACE_EVENTS)
+    {
+        ++data.dropped;
+        return;
+    }
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    data.events.push_back({ name,
+                            duration_cast<microseconds>(begin - data.start).count(),
+                            duration_cast<microseconds>(end - begin).count(),
+                            thread });
+}
+
+//---------------------------------------------------------------------------------------
+void Tracer::stop()
+{
+    //Writes the events in the Trace Event Format, as 'complete' (ph:X) events
+
+    TraceData& data = get_data();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    if (!m_fEnabled)
+        return;
+    m_fEnabled = false;
+
+    std::ofstream file(data.filename.fn_str(), std::ios::trunc);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << data.mainThread
+         << ",\"args\":{\"name\":\"main\"}}";
+    for (const TraceEvent& event : data.events)
+    {
+        file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+             << event.thread << ",\"ts\":" << event.begin << ",\"dur\":" << event.duration
+             << "}";
+    }
+    file << "\n]}\n";
+    file.close();
+
+    if (!file)
+        wxLogError("[Tracer::stop] Could not write file '%s'", data.filename);
+    else
+        wxLogMessage("[Tracer::stop] %lu events written to '%s'. %lu dropped",
+                     (unsigned long)data.events.size(), data.filename,
+                     (unsigned long)data.dropped);
+
+    data.events.clear();
+    data.events.shrink_to_fit();
+}
+
+
+} // namespace agrilla
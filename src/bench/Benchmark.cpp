@@ -0,0 +1,324 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the AGrilla application.
+// Copyright (c) 2025-present, Cecilio Salmeron
+//
+// Licensed under the MIT license.
+//
+// See LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx/wxprec.h".
+#include "wx/wxprec.h"
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+//wxWidgets
+#include <wx/log.h>
+
+//agrilla
+#include "Benchmark.h"
+#include "MainFrame.h"
+#include "PixelRasterizer.h"
+#include "TheApp.h"
+
+//std
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+
+//log messages from this file belong to the 'agrilla/bench' module
+#define wxLOG_COMPONENT "agrilla/bench"
+
+
+namespace agrilla
+{
+
+//---------------------------------------------------------------------------------------
+wxString BenchmarkCase::get_key() const
+{
+    return wxString::Format("%dx%d-s%d-t%d-g%d-gl%d-f%d", width, height, segments,
+                            thickness, int(fGrid), int(fGoldenLines), int(fFrame));
+}
+
+
+//=======================================================================================
+// Benchmark implementation
+//=======================================================================================
+Benchmark::Benchmark(MainFrame* pFrame, const BenchmarkOptions& options)
+    : m_pFrame(pFrame)
+    , m_options(options)
+{
+}
+
+//---------------------------------------------------------------------------------------
+int Benchmark::run()
+{
+    std::vector<BenchmarkCase> cases = create_cases();
+    std::vector<BenchmarkResult> results;
+    results.reserve(cases.size());
+
+    for (const BenchmarkCase& bcase : cases)
+    {
+        results.push_back( measure(bcase) );
+        std::cerr << "." << std::flush;
+    }
+    std::cerr << std::endl;
+
+    wxString json = results_to_json(results);
+    if (m_options.outputFile.IsEmpty())
+        std::cout << json.ToStdString();
+    else
+        write_file(m_options.outputFile, json);
+
+    int exitCode = 0;
+    if (!m_options.baselineFile.IsEmpty())
+        exitCode = compare_with_baseline(results);
+
+    if (!m_options.saveBaselineFile.IsEmpty())
+        write_file(m_options.saveBaselineFile, json);
+
+    return exitCode;
+}
+
+//---------------------------------------------------------------------------------------
+std::vector<BenchmarkCase> Benchmark::create_cases() const
+{
+    struct Size { int width; int height; };
+    std::vector<Size> sizes = { {400, 300}, {800, 600}, {1280, 720}, {1920, 1080},
+                                {2560, 1440}, {3840, 2160}, {7680, 4320} };
+    std::vector<int> segments = { 2, 3, 25, 100 };
+    std::vector<int> thickness = { 1, 5, 10 };
+
+    if (m_options.fQuick)
+    {
+        sizes = { {400, 300}, {1920, 1080}, {7680, 4320} };
+        segments = { 3, 100 };
+        thickness = { 1, 10 };
+    }
+
+    //grid, golden lines, frame
+    const bool combinations[][3] = { {true, false, false},
+                                     {true, true, false},
+                                     {true, true, true},
+                                     {false, true, true} };
+
+    std::vector<BenchmarkCase> cases;
+    for (const Size& size : sizes)
+    {
+        for (int numSegments : segments)
+        {
+            for (int lineThickness : thickness)
+            {
+                for (const auto& flags : combinations)
+                {
+                    cases.push_back({ size.width, size.height, numSegments, lineThickness,
+                                      flags[0], flags[1], flags[2] });
+                }
+            }
+        }
+    }
+    return cases;
+}
+
+//---------------------------------------------------------------------------------------
+template <typename F>
+double Benchmark::median_time(F stage)
+{
+    //Runs the stage m_options.repeat times and returns the median time, in microseconds
+    std::vector<double> times;
+    for (int i = 0; i < std::max(m_options.repeat, 1); ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        stage();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back( std::chrono::duration<double, std::micro>(end - start).count() );
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+//---------------------------------------------------------------------------------------
+void Benchmark::prepare_frame(const BenchmarkCase& bcase)
+{
+    MainFrame* pFrame = m_pFrame;
+    pFrame->m_gridSize = bcase.segments;
+    pFrame->m_gridLineThickness = bcase.thickness;
+    pFrame->m_fDrawGrid = bcase.fGrid;
+    pFrame->m_fDrawGoldenLines = bcase.fGoldenLines;
+    pFrame->m_fDrawFrame = bcase.fFrame;
+    pFrame->SetClientSize(bcase.width, bcase.height);
+    pFrame->invalidate_all_layers();
+
+    //measure the building of layers and shapes, not the restoring from the cache,
+    //and build them in the UI thread
+    pFrame->m_shapeCache.set_budget(0);
+    pFrame->m_pRenderThread.reset();
+
+    //let the window process the resize before measuring
+    wxTheApp->Yield(true);
+}
+
+//---------------------------------------------------------------------------------------
+BenchmarkResult Benchmark::measure(const BenchmarkCase& bcase)
+{
+    prepare_frame(bcase);
+
+    MainFrame* pFrame = m_pFrame;
+    BenchmarkResult result;
+    result.bcase = bcase;
+
+    const GridLayoutOptions& options = pFrame->m_layout.get_options();
+    result.layout = median_time([&options]() {
+        GridLayout layout;
+        layout.update(options);
+    });
+
+    result.rasterize = median_time([pFrame]() {
+        pFrame->invalidate_all_layers();
+        pFrame->build_mask();
+    });
+
+    result.regionAnalytic = median_time([pFrame]() {
+        wxRegion rgn = pFrame->m_shape.build_region();
+    });
+
+    result.applyShape = median_time([pFrame]() {
+        pFrame->m_shape.apply_to(pFrame);
+    });
+
+    result.paint = median_time([pFrame]() {
+        pFrame->Refresh(false);
+        pFrame->Update();
+    });
+
+    wxSize size = pFrame->GetClientSize();
+    std::vector<unsigned char> pixels(size_t(size.x) * size.y * 3);
+    PixelBuffer buffer;
+    buffer.pData = pixels.data();
+    buffer.stride = size.x * 3;
+    buffer.width = size.x;
+    buffer.height = size.y;
+    result.pixelFill = median_time([pFrame, &buffer]() {
+        PixelRasterizer::fill_layers(buffer, pFrame->m_layers,
+                                     wxRect(0, 0, buffer.width, buffer.height), nullptr);
+    });
+
+    result.numRects = pFrame->m_shape.get_rects().size();
+    return result;
+}
+
+//---------------------------------------------------------------------------------------
+wxString Benchmark::result_to_json(const BenchmarkResult& result) const
+{
+    const BenchmarkCase& bcase = result.bcase;
+    wxString json = "{";
+    json += "\"key\":\"" + bcase.get_key() + "\"";
+    json += wxString::Format(",\"width\":%d,\"height\":%d,\"segments\":%d,\"thickness\":%d",
+                             bcase.width, bcase.height, bcase.segments, bcase.thickness);
+    json += ",\"grid\":" + wxString(bcase.fGrid ? "true" : "false");
+    json += ",\"golden_lines\":" + wxString(bcase.fGoldenLines ? "true" : "false");
+    json += ",\"frame\":" + wxString(bcase.fFrame ? "true" : "false");
+    json += ",\"layout_us\":" + wxString::FromCDouble(result.layout, 1);
+    json += ",\"rasterize_us\":" + wxString::FromCDouble(result.rasterize, 1);
+    json += ",\"region_analytic_us\":" + wxString::FromCDouble(result.regionAnalytic, 1);
+    json += ",\"apply_shape_us\":" + wxString::FromCDouble(result.applyShape, 1);
+    json += ",\"paint_us\":" + wxString::FromCDouble(result.paint, 1);
+    json += ",\"pixel_fill_us\":" + wxString::FromCDouble(result.pixelFill, 1);
+    json += ",\"total_us\":" + wxString::FromCDouble(result.get_total(), 1);
+    json += wxString::Format(",\"rects\":%d", int(result.numRects));
+    json += "}";
+    return json;
+}
+
+//---------------------------------------------------------------------------------------
+wxString Benchmark::results_to_json(const std::vector<BenchmarkResult>& results) const
+{
+    //one result per line, to simplify comparing with a baseline
+    wxString json = "{\n";
+    json += "\"version\":\"" + TheApp::get_version_long_string() + "\",\n";
+    json += wxString::Format("\"repeat\":%d,\n", m_options.repeat);
+    json += "\"results\":[\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        json += result_to_json(results[i]);
+        json += (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    json += "]\n}\n";
+    return json;
+}
+
+//---------------------------------------------------------------------------------------
+bool Benchmark::write_file(const wxString& filename, const wxString& content) const
+{
+    std::ofstream file(filename.ToStdString());
+    if (!file)
+    {
+        wxLogError("[Benchmark::write_file] Could not write file '%s'", filename);
+        return false;
+    }
+    file << content.ToStdString();
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+int Benchmark::compare_with_baseline(const std::vector<BenchmarkResult>& results) const
+{
+    //Compares total times with the baseline. Returns 1 if any case is slower than
+    //the baseline by more than the threshold, 0 otherwise.
+    //Very short timings are ignored, as they are dominated by noise
+
+    const double k_minRelevantUs = 200.0;
+
+    std::ifstream file(m_options.baselineFile.ToStdString());
+    if (!file)
+    {
+        std::cerr << "Baseline file '" << m_options.baselineFile.ToStdString()
+                  << "' not found. Nothing to compare." << std::endl;
+        return 0;
+    }
+
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        size_t keyPos = line.find("\"key\":\"");
+        size_t totalPos = line.find("\"total_us\":");
+        if (keyPos == std::string::npos || totalPos == std::string::npos)
+            continue;
+
+        keyPos += 7;
+        std::string key = line.substr(keyPos, line.find('"', keyPos) - keyPos);
+        double total = 0.0;
+        if (wxString(line.substr(totalPos + 11)).BeforeFirst(',').BeforeFirst('}').ToCDouble(&total))
+            baseline[key] = total;
+    }
+
+    int numRegressions = 0;
+    for (const BenchmarkResult& result : results)
+    {
+        auto it = baseline.find(result.bcase.get_key().ToStdString());
+        if (it == baseline.end())
+            continue;
+
+        double total = result.get_total();
+        if (total > k_minRelevantUs && total > it->second * (1.0 + m_options.threshold))
+        {
+            ++numRegressions;
+            std::cerr << "REGRESSION " << it->first << ": " << int(it->second) << " us -> "
+                      << int(total) << " us" << std::endl;
+        }
+    }
+
+    std::cerr << numRegressions << " regressions found, compared with '"
+              << m_options.baselineFile.ToStdString() << "'" << std::endl;
+    return (numRegressions > 0 ? 1 : 0);
+}
+
+
+} // namespace agrilla
@@ -12,6 +12,10 @@
 #include <wx/msgdlg.h>
 #include <sstream>
 
+//log messages from this file belong to the 'agrilla/dialogs' module
+#define wxLOG_COMPONENT "agrilla/dialogs"
+
+
 namespace agrilla
 {
 